@@ -145,10 +145,81 @@ int analogRead(uint8_t pin);
 void analogReference(uint8_t mode);
 void analogWrite(uint8_t pin, int val);
 void analogReadResolution(uint8_t res);
+void analogReadOversampling(uint8_t bits);
+
+// fast pwm with ICR top on Timer1/Timer3, returns the resolution in bits
+// for the frequency, see wiring_pwm.c
+uint8_t analogWriteFrequency(uint8_t pin, uint32_t hz);
+void analogWriteHR(uint8_t pin, uint16_t duty);
+
+// Timer1/Timer3 clock from the doubled oscillator, 64MHz with the internal
+// 32MHz RC (TCKCSR F2XEN/TC2XS), see wiring.c; timerClock() gives the
+// clock ahead of the prescaler that pwm and DDS periods are worked out from;
+// running pwm keeps its frequency, Timer1 stays on the system clock while
+// it is the cycles() counter, and a timer running DDS, tone() or the
+// Timer3 capture is left on its clock
+#define TIMER_FAST_CLOCK1	0x01
+#define TIMER_FAST_CLOCK3	0x02
+void timerFastClock(uint8_t timers);
+uint32_t timerClock(uint8_t timer);
+
+// complementary pwm with dead time (LGT8FX8P) on OC1A/OC1B or OC3A/OC3B,
+// pin is the A output; the comparator (AIN0 above AIN1) or INT0/INT1
+// shuts both off
+#define HALF_BRIDGE_FAULT_NONE	0
+#define HALF_BRIDGE_FAULT_AC	1
+#define HALF_BRIDGE_FAULT_INT0	2
+#define HALF_BRIDGE_FAULT_INT1	3
+uint8_t halfBridgeBegin(uint8_t pin, uint32_t hz, uint16_t deadtime, uint8_t fault);
+void halfBridgeWrite(uint8_t pin, uint16_t duty);
+uint8_t halfBridgeFault(uint8_t pin);
+void halfBridgeResume(uint8_t pin);
+void halfBridgeEnd(uint8_t pin);
+
+// interrupt driven ADC sampling into a ring buffer, see wiring_analog_stream.c
+// trigger is one of the ADTS sources below; the buffer holds len - 1 samples
+#define ADC_FREE_RUNNING		0
+#define ADC_TRIGGER_COMPARATOR		1
+#define ADC_TRIGGER_INT0		2
+#define ADC_TRIGGER_TIMER0_COMPA	3
+#define ADC_TRIGGER_TIMER0_OVF		4
+#define ADC_TRIGGER_TIMER1_COMPB	5
+#define ADC_TRIGGER_TIMER1_OVF		6
+#define ADC_TRIGGER_TIMER1_CAPT		7
+uint8_t analogStreamBegin(uint8_t pin, uint16_t *buf, uint8_t len, uint8_t trigger);
+void analogStreamEnd(void);
+uint8_t analogStreamAvailable(void);
+int analogStreamRead(void);
+uint16_t analogStreamOverruns(void);
+// called from the ADC interrupt for every sample, returning ANALOG_STREAM_SKIP drops it
+#define ANALOG_STREAM_SKIP	0xffff
+void analogStreamHook(uint16_t (*hook)(uint16_t val));
+
+// multi-channel scan on each trigger with a double buffered result table,
+// see wiring_analog_scan.c; owns the ADC interrupt like analogStream
+#define ANALOG_SCAN_MAX	10
+uint8_t analogScanBegin(const uint8_t *pins, uint8_t count, uint8_t trigger);
+void analogScanEnd(void);
+uint16_t analogScanSnapshot(uint16_t *values);
+uint16_t analogScanSequence(void);
+int analogScanRead(uint8_t index);
+
+// hardware threshold monitor (LGT8FX8P), the callback runs from the ADC
+// interrupt once per excursion, see wiring_analog_monitor.c
+#define ANALOG_MONITOR_LOW	1
+#define ANALOG_MONITOR_HIGH	2
+uint8_t analogMonitor(uint8_t pin, uint16_t low, uint16_t high, uint8_t filter, void (*callback)(uint8_t event, uint16_t value));
+void analogMonitorResume(void);
+void analogMonitorEnd(void);
+uint8_t analogMonitorEvent(void);
 
 unsigned long millis(void);
 unsigned long micros(void);
 void delay(unsigned long ms);
+// IDLE sleep between timer interrupts, see wiring.c
+void delayIdle(uint8_t enable);
+void idleSleep(uint32_t us);
+uint32_t idleTime(void);
 __inline__ void  delayMicroseconds  (double us)             __attribute__ ((always_inline, unused)); // for variable case
 __inline__ void _lgt8fx_delay_cycles(const uint32_t cticks) __attribute__ ((always_inline, unused)); // for constant case
 unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout);
@@ -156,10 +227,43 @@ unsigned long pulseInLong(uint8_t pin, uint8_t state, unsigned long timeout);
 
 void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
 uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);
+void shiftOutBuffer(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, const uint8_t *buf, uint16_t len);
+void shiftInBuffer(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t *buf, uint16_t len);
+void shiftClock(uint32_t hz);
 
 void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
 void detachInterrupt(uint8_t interruptNum);
 
+// compile time bound external interrupt: ATTACH_INTERRUPT_FAST(0, func)
+// at file scope makes func the INT0 vector body, with no function pointer
+// in between, so a static inline func only saves the registers it uses.
+// attachInterruptFast(0, mode) then enables it, detachInterrupt() works
+// as usual.
+#define ATTACH_INTERRUPT_FAST(num, func)	ISR(INT##num##_vect) { func(); }
+void attachInterruptFast(uint8_t interruptNum, int mode);
+
+// cooperative scheduler, tasks run after loop() and from yield(), see
+// scheduler.c; period 0 runs the task once. The statistics are kept in
+// the task: runs, runs started late (late, max_late in ms) and runs that
+// took longer than the period (overruns, max_run in us)
+typedef struct sched_task {
+	struct sched_task *next;
+	struct sched_task **pprev;
+	void (*func)(void);
+	uint32_t due;
+	uint32_t period;
+	uint32_t runs;
+	uint32_t max_run;
+	uint16_t late;
+	uint16_t max_late;
+	uint16_t overruns;
+} sched_task_t;
+void schedulerAdd(sched_task_t *task, void (*func)(void), uint32_t delay, uint32_t period);
+void schedulerCancel(sched_task_t *task);
+uint8_t schedulerPending(sched_task_t *task);
+uint32_t schedulerIdleTime(void);
+void schedulerRun(void) __attribute__((weak));
+
 void setup(void);
 void loop(void);
 
@@ -624,9 +728,17 @@ long map(long, long, long, long, long);
 #endif
 
 #include "pins_arduino.h"
+#include "fastio_pin.h"
+#include "pin_handle.h"
+#include "parallel_bus.h"
+#include "profile.h"
+#include "pcint.h"
 
 #if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
 #include "fastio_digital.h"
+#include "udsc.h"
+#include "dds.h"
+#include "capture.h"
 
 #define	INT_OSC	0
 #define	EXT_OSC	1
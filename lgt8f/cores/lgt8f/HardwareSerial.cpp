@@ -77,12 +77,19 @@ void serialEventRun(void)
 #endif
 }
 
-// macro to guard critical sections when needed for large TX buffer sizes
-#if (SERIAL_TX_BUFFER_SIZE>256)
+// macros to guard reading the 16 bit index that the interrupt moves
 #define TX_BUFFER_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-#else
-#define TX_BUFFER_ATOMIC
-#endif
+#define RX_BUFFER_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+
+inline tx_buffer_index_t HardwareSerial::_tx_tail(void)
+{
+  tx_buffer_index_t tail;
+
+  TX_BUFFER_ATOMIC {
+    tail = _tx_buffer_tail;
+  }
+  return tail;
+}
 
 // Actual interrupt handlers //////////////////////////////////////////////////////////////
 
@@ -90,8 +97,8 @@ void HardwareSerial::_tx_udr_empty_irq(void)
 {
   // If interrupts are enabled, there must be more data in the output
   // buffer. Send the next byte
-  unsigned char c = _tx_buffer[_tx_buffer_tail];
-  _tx_buffer_tail = (_tx_buffer_tail + 1) % SERIAL_TX_BUFFER_SIZE;
+  unsigned char c = _tx_ring[_tx_buffer_tail];
+  _tx_buffer_tail = TX_BUFFER_WRAP((unsigned int)_tx_buffer_tail + 1);
 
   *_udr = c;
 
@@ -114,8 +121,35 @@ void HardwareSerial::_tx_udr_empty_irq(void)
 
 // Public Methods //////////////////////////////////////////////////////////////
 
-void HardwareSerial::begin(unsigned long baud, byte config)
+void HardwareSerial::begin(unsigned long baud, byte config,
+  uint8_t *rxBuf, uint16_t rxLen, uint8_t *txBuf, uint16_t txLen)
 {
+  // nothing may still be queued in the ring that is replaced
+  if (bit_is_set(*_ucsrb, TXEN0))
+    flush();
+
+  if (rxBuf == 0 || rxLen < 2) {
+    rxBuf = _rx_buffer;
+    rxLen = SERIAL_RX_BUFFER_SIZE;
+  }
+  if (txBuf == 0 || txLen < 2) {
+    txBuf = _tx_buffer;
+    txLen = SERIAL_TX_BUFFER_SIZE;
+  }
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    cbi(*_ucsrb, RXCIE0);
+    cbi(*_ucsrb, UDRIE0);
+    _rx_ring = rxBuf;
+    _rx_size = rxLen > SERIAL_BUFFER_MAX ? SERIAL_BUFFER_MAX : rxLen;
+    _rx_mask = BUFFER_MASK(_rx_size);
+    _tx_ring = txBuf;
+    _tx_size = txLen > SERIAL_BUFFER_MAX ? SERIAL_BUFFER_MAX : txLen;
+    _tx_mask = BUFFER_MASK(_tx_size);
+    _rx_buffer_head = _rx_buffer_tail = 0;
+    _tx_buffer_head = _tx_buffer_tail = 0;
+  }
+
   // Try u2x mode first
   uint16_t baud_setting = (F_CPU / 4 / baud - 1) / 2;
   *_ucsra = 1 << U2X0;
@@ -165,30 +199,90 @@ void HardwareSerial::end()
 
 int HardwareSerial::available(void)
 {
-  return ((unsigned int)(SERIAL_RX_BUFFER_SIZE + _rx_buffer_head - _rx_buffer_tail)) % SERIAL_RX_BUFFER_SIZE;
+  rx_buffer_index_t head;
+
+  RX_BUFFER_ATOMIC {
+    head = _rx_buffer_head;
+  }
+  return RX_BUFFER_WRAP((unsigned int)(_rx_size + head - _rx_buffer_tail));
 }
 
 int HardwareSerial::peek(void)
 {
-  if (_rx_buffer_head == _rx_buffer_tail) {
+  rx_buffer_index_t head;
+
+  RX_BUFFER_ATOMIC {
+    head = _rx_buffer_head;
+  }
+  if (head == _rx_buffer_tail) {
     return -1;
   } else {
-    return _rx_buffer[_rx_buffer_tail];
+    return _rx_ring[_rx_buffer_tail];
   }
 }
 
 int HardwareSerial::read(void)
 {
+  rx_buffer_index_t head;
+
+  RX_BUFFER_ATOMIC {
+    head = _rx_buffer_head;
+  }
   // if the head isn't ahead of the tail, we don't have any characters
-  if (_rx_buffer_head == _rx_buffer_tail) {
+  if (head == _rx_buffer_tail) {
     return -1;
   } else {
-    unsigned char c = _rx_buffer[_rx_buffer_tail];
-    _rx_buffer_tail = (rx_buffer_index_t)(_rx_buffer_tail + 1) % SERIAL_RX_BUFFER_SIZE;
+    unsigned char c = _rx_ring[_rx_buffer_tail];
+    RX_BUFFER_ATOMIC {
+      _rx_buffer_tail = RX_BUFFER_WRAP((unsigned int)_rx_buffer_tail + 1);
+    }
     return c;
   }
 }
 
+// Copies what is in the ring, at most two runs split by the wrap, and
+// frees it with a single tail update. Only the interrupt moves the head.
+size_t HardwareSerial::_rx_drain(char *buffer, size_t length)
+{
+  rx_buffer_index_t head, tail = _rx_buffer_tail;
+  size_t count = 0, n;
+
+  RX_BUFFER_ATOMIC {
+    head = _rx_buffer_head;
+  }
+
+  while (count < length && tail != head) {
+    n = (head > tail ? head : _rx_size) - tail;
+    if (n > length - count)
+      n = length - count;
+    memcpy(buffer + count, &_rx_ring[tail], n);
+    count += n;
+    tail = RX_BUFFER_WRAP((unsigned int)tail + n);
+  }
+
+  RX_BUFFER_ATOMIC {
+    _rx_buffer_tail = tail;
+  }
+  return count;
+}
+
+size_t HardwareSerial::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0, n;
+  unsigned long start = millis();
+
+  while (count < length) {
+    n = _rx_drain(buffer + count, length - count);
+    if (n) {
+      count += n;
+      start = millis();
+    } else if (millis() - start >= _timeout) {
+      break;
+    }
+  }
+  return count;
+}
+
 int HardwareSerial::availableForWrite(void)
 {
   tx_buffer_index_t head;
@@ -198,7 +292,7 @@ int HardwareSerial::availableForWrite(void)
     head = _tx_buffer_head;
     tail = _tx_buffer_tail;
   }
-  if (head >= tail) return SERIAL_TX_BUFFER_SIZE - 1 - head + tail;
+  if (head >= tail) return _tx_size - 1 - head + tail;
   return tail - head - 1;
 }
 
@@ -222,37 +316,43 @@ void HardwareSerial::flush()
   // the hardware finished tranmission (TXC is set).
 }
 
+void HardwareSerial::_tx_udr_write(uint8_t c)
+{
+  // If TXC is cleared before writing UDR and the previous byte
+  // completes before writing to UDR, TXC will be set but a byte
+  // is still being transmitted causing flush() to return too soon.
+  // So writing UDR must happen first.
+  // Writing UDR and clearing TC must be done atomically, otherwise
+  // interrupts might delay the TXC clear so the byte written to UDR
+  // is transmitted (setting TXC) before clearing TXC. Then TXC will
+  // be cleared when no bytes are left, causing flush() to hang
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *_udr = c;
+#ifdef MPCM0
+    *_ucsra = ((*_ucsra) & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
+#else
+    *_ucsra = ((*_ucsra) & ((1 << U2X0) | (1 << TXC0)));
+#endif
+  }
+}
+
 size_t HardwareSerial::write(uint8_t c)
 {
+  PROFILE_CORE(PROFILE_SERIAL_WRITE);
   _written = true;
   // If the buffer and the data register is empty, just write the byte
   // to the data register and be done. This shortcut helps
   // significantly improve the effective datarate at high (>
   // 500kbit/s) bitrates, where interrupt overhead becomes a slowdown.
-  if (_tx_buffer_head == _tx_buffer_tail && bit_is_set(*_ucsra, UDRE0)) {
-    // If TXC is cleared before writing UDR and the previous byte
-    // completes before writing to UDR, TXC will be set but a byte
-    // is still being transmitted causing flush() to return too soon.
-    // So writing UDR must happen first.
-    // Writing UDR and clearing TC must be done atomically, otherwise
-    // interrupts might delay the TXC clear so the byte written to UDR
-    // is transmitted (setting TXC) before clearing TXC. Then TXC will
-    // be cleared when no bytes are left, causing flush() to hang
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-      *_udr = c;
-#ifdef MPCM0
-      *_ucsra = ((*_ucsra) & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
-#else
-      *_ucsra = ((*_ucsra) & ((1 << U2X0) | (1 << TXC0)));
-#endif
-    }
+  if (_tx_buffer_head == _tx_tail() && bit_is_set(*_ucsra, UDRE0)) {
+    _tx_udr_write(c);
     return 1;
   }
-  tx_buffer_index_t i = (_tx_buffer_head + 1) % SERIAL_TX_BUFFER_SIZE;
+  tx_buffer_index_t i = TX_BUFFER_WRAP((unsigned int)_tx_buffer_head + 1);
 	
   // If the output buffer is full, there's nothing for it other than to 
   // wait for the interrupt handler to empty it a bit
-  while (i == _tx_buffer_tail) {
+  while (i == _tx_tail()) {
     if (bit_is_clear(SREG, SREG_I)) {
       // Interrupts are disabled, so we'll have to poll the data
       // register empty flag ourselves. If it is set, pretend an
@@ -265,7 +365,7 @@ size_t HardwareSerial::write(uint8_t c)
     }
   }
 
-  _tx_buffer[_tx_buffer_head] = c;
+  _tx_ring[_tx_buffer_head] = c;
 
   // make atomic to prevent execution of ISR between setting the
   // head pointer and setting the interrupt flag resulting in buffer
@@ -278,4 +378,54 @@ size_t HardwareSerial::write(uint8_t c)
   return 1;
 }
 
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  PROFILE_CORE(PROFILE_SERIAL_WRITE);
+  tx_buffer_index_t head, tail;
+  size_t left = size, n;
+
+  if (size == 0)
+    return 0;
+  _written = true;
+
+  // the first byte goes straight out when the transmitter is idle, as
+  // in write(uint8_t)
+  if (_tx_buffer_head == _tx_tail() && bit_is_set(*_ucsra, UDRE0)) {
+    _tx_udr_write(*buffer++);
+    left--;
+  }
+
+  while (left) {
+    head = _tx_buffer_head;
+    tail = _tx_tail();
+
+    // free run from the head up to the tail or the end of the ring,
+    // one slot stays empty to tell a full ring from an empty one
+    if (tail > head)
+      n = tail - head - 1;
+    else
+      n = _tx_size - head - (tail == 0);
+
+    if (n == 0) {
+      // full, wait for the interrupt as write(uint8_t) does
+      if (bit_is_clear(SREG, SREG_I) && bit_is_set(*_ucsra, UDRE0))
+        _tx_udr_empty_irq();
+      continue;
+    }
+
+    if (n > left)
+      n = left;
+    memcpy(&_tx_ring[head], buffer, n);
+    buffer += n;
+    left -= n;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      _tx_buffer_head = TX_BUFFER_WRAP((unsigned int)head + n);
+      sbi(*_ucsrb, UDRIE0);
+    }
+  }
+
+  return size;
+}
+
 #endif // whole file
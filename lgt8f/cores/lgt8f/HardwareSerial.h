@@ -32,19 +32,11 @@
 // using a ring buffer (I think), in which head is the index of the location
 // to which to write the next incoming character and tail is the index of the
 // location from which to read.
-// NOTE: a "power of 2" buffer size is reccomended to dramatically
-//       optimize all the modulo operations for ring buffers.
-// WARNING: When buffer sizes are increased to > 256, the buffer index
-// variables are automatically increased in size, but the extra
-// atomicity guards needed for that are not implemented. This will
-// often work, but occasionally a race condition can occur that makes
-// Serial behave erratically. See https://github.com/arduino/Arduino/issues/2405
+// The index arithmetic wraps without a division, any size is fine.
+// The default rings are always allocated, so they are kept small: a full
+// tx ring only makes write() wait, and rx keeps the board menu's size.
 #if !defined(SERIAL_TX_BUFFER_SIZE)
-#if ((RAMEND - RAMSTART) < 1023)
 #define SERIAL_TX_BUFFER_SIZE 16
-#else
-#define SERIAL_TX_BUFFER_SIZE 64
-#endif
 #endif
 #if !defined(SERIAL_RX_BUFFER_SIZE)
 #if ((RAMEND - RAMSTART) < 1023)
@@ -53,16 +45,13 @@
 #define SERIAL_RX_BUFFER_SIZE 64
 #endif
 #endif
-#if (SERIAL_TX_BUFFER_SIZE>256)
+// The buffers above are the default ones. begin() can take buffers from
+// the sketch instead, of up to SERIAL_BUFFER_MAX bytes, so the indexes
+// are 16 bit and read atomically; the defaults stay allocated next to
+// them.
+#define SERIAL_BUFFER_MAX 1024
 typedef uint16_t tx_buffer_index_t;
-#else
-typedef uint8_t tx_buffer_index_t;
-#endif
-#if  (SERIAL_RX_BUFFER_SIZE>256)
 typedef uint16_t rx_buffer_index_t;
-#else
-typedef uint8_t rx_buffer_index_t;
-#endif
 
 // Define config for Serial.begin(baud, config);
 #define SERIAL_5N1 0x00
@@ -107,6 +96,15 @@ class HardwareSerial : public Stream
     volatile tx_buffer_index_t _tx_buffer_head;
     volatile tx_buffer_index_t _tx_buffer_tail;
 
+    // the rings in use, the buffers below or the ones given to begin()
+    unsigned char *_rx_ring;
+    unsigned char *_tx_ring;
+    rx_buffer_index_t _rx_size;
+    tx_buffer_index_t _tx_size;
+    // size - 1 when the size is a power of two, else 0
+    rx_buffer_index_t _rx_mask;
+    tx_buffer_index_t _tx_mask;
+
     // Don't put any members after these buffers, since only the first
     // 32 bytes of this struct can be accessed quickly using the ldd
     // instruction.
@@ -119,7 +117,12 @@ class HardwareSerial : public Stream
       volatile uint8_t *ucsra, volatile uint8_t *ucsrb,
       volatile uint8_t *ucsrc, volatile uint8_t *udr);
     void begin(unsigned long baud) { begin(baud, SERIAL_8N1); }
-    void begin(unsigned long, uint8_t);
+    void begin(unsigned long baud, uint8_t config) { begin(baud, config, 0, 0, 0, 0); }
+    // A null buffer or a size below 2 keeps the default buffer of that
+    // direction, sizes above SERIAL_BUFFER_MAX are cut. The buffers stay
+    // in use until the next begin(), pending output is sent first.
+    void begin(unsigned long baud, uint8_t config,
+      uint8_t *rxBuf, uint16_t rxLen, uint8_t *txBuf, uint16_t txLen);
     void end();
     virtual int available(void);
     virtual int peek(void);
@@ -127,16 +130,27 @@ class HardwareSerial : public Stream
     virtual int availableForWrite(void);
     virtual void flush(void);
     virtual size_t write(uint8_t);
+    // copies whole runs into the ring and starts the interrupt once
+    virtual size_t write(const uint8_t *buffer, size_t size);
     inline size_t write(unsigned long n) { return write((uint8_t)n); }
     inline size_t write(long n) { return write((uint8_t)n); }
     inline size_t write(unsigned int n) { return write((uint8_t)n); }
     inline size_t write(int n) { return write((uint8_t)n); }
     using Print::write; // pull in write(str) and write(buf, size) from Print
+    // takes everything received so far at once, then waits with the
+    // stream timeout like Stream::readBytes()
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
     operator bool() { return true; }
 
     // Interrupt handlers - Not intended to be called externally
     inline void _rx_complete_irq(void);
     void _tx_udr_empty_irq(void);
+
+  private:
+    inline void _tx_udr_write(uint8_t c);
+    inline tx_buffer_index_t _tx_tail(void);
+    size_t _rx_drain(char *buffer, size_t length);
 };
 
 #if defined(UBRRH) || defined(UBRR0H)
@@ -46,6 +46,7 @@
   #error "Don't know what the Data Received vector is called for Serial"
 #endif
   {
+    PROFILE_CORE(PROFILE_ISR_SERIAL_RX);
     Serial._rx_complete_irq();
   }
 
@@ -61,6 +62,7 @@ ISR(USART_UDRE_vect)
   #error "Don't know what the Data Register Empty vector is called for Serial"
 #endif
 {
+  PROFILE_CORE(PROFILE_ISR_SERIAL_TX);
   Serial._tx_udr_empty_irq();
 }
 
@@ -82,6 +82,17 @@
 #error "Not all bit positions for UART3 are the same as for UART0"
 #endif
 
+// Ring buffer index arithmetic. The ring size is only known at run time
+// since begin() may hand over a buffer of any size. A power of two ring,
+// the default 64 byte ones included, wraps with its mask, any other size
+// (the 250 byte buffer of the ISP board menu) with a compare and
+// subtract, never with a division.
+#define RX_BUFFER_WRAP(i) ((rx_buffer_index_t)(_rx_mask ? (i) & _rx_mask : \
+  ((i) >= _rx_size ? (i) - _rx_size : (i))))
+#define TX_BUFFER_WRAP(i) ((tx_buffer_index_t)(_tx_mask ? (i) & _tx_mask : \
+  ((i) >= _tx_size ? (i) - _tx_size : (i))))
+#define BUFFER_MASK(size) (((size) & ((size) - 1)) ? 0 : (size) - 1)
+
 // Constructors ////////////////////////////////////////////////////////////////
 
 HardwareSerial::HardwareSerial(
@@ -92,7 +103,11 @@ HardwareSerial::HardwareSerial(
     _ucsra(ucsra), _ucsrb(ucsrb), _ucsrc(ucsrc),
     _udr(udr),
     _rx_buffer_head(0), _rx_buffer_tail(0),
-    _tx_buffer_head(0), _tx_buffer_tail(0)
+    _tx_buffer_head(0), _tx_buffer_tail(0),
+    _rx_ring(_rx_buffer), _tx_ring(_tx_buffer),
+    _rx_size(SERIAL_RX_BUFFER_SIZE), _tx_size(SERIAL_TX_BUFFER_SIZE),
+    _rx_mask(BUFFER_MASK(SERIAL_RX_BUFFER_SIZE)),
+    _tx_mask(BUFFER_MASK(SERIAL_TX_BUFFER_SIZE))
 {
 }
 
@@ -104,14 +119,14 @@ void HardwareSerial::_rx_complete_irq(void)
     // No Parity error, read byte and store it in the buffer if there is
     // room
     unsigned char c = *_udr;
-    rx_buffer_index_t i = (unsigned int)(_rx_buffer_head + 1) % SERIAL_RX_BUFFER_SIZE;
+    rx_buffer_index_t i = RX_BUFFER_WRAP((unsigned int)_rx_buffer_head + 1);
 
     // if we should be storing the received character into the location
     // just before the tail (meaning that the head would advance to the
     // current location of the tail), we're about to overflow the buffer
     // and so we don't write the character or advance the head.
     if (i != _rx_buffer_tail) {
-      _rx_buffer[_rx_buffer_head] = c;
+      _rx_ring[_rx_buffer_head] = c;
       _rx_buffer_head = i;
     }
   } else {
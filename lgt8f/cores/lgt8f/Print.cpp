@@ -202,6 +202,7 @@ size_t Print::println(const Printable& x)
 
 size_t Print::printNumber(unsigned long n, uint8_t base)
 {
+  PROFILE_CORE(PROFILE_PRINT_NUMBER);
   char buf[8 * sizeof(long) + 1]; // Assumes 8-bit chars plus zero byte.
   char *str = &buf[sizeof(buf) - 1];
 
@@ -211,8 +212,13 @@ size_t Print::printNumber(unsigned long n, uint8_t base)
   if (base < 2) base = 10;
 
   do {
+#if LGT_UDSC && defined(__LGT8FX8P__)
+    uint16_t c;
+    n = udscDivMod32(n, base, &c);
+#else
     char c = n % base;
     n /= base;
+#endif
 
     *--str = c < 10 ? c + '0' : c + 'A' - 10;
   } while(n);
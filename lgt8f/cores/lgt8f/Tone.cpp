@@ -497,6 +497,7 @@ void noTone(uint8_t _pin)
 #ifdef USE_TIMER0
 ISR(TIMER0_COMPA_vect)
 {
+  PROFILE_CORE(PROFILE_ISR_TONE);
   if (timer0_toggle_count != 0)
   {
     // toggle the pin
@@ -517,6 +518,7 @@ ISR(TIMER0_COMPA_vect)
 #ifdef USE_TIMER1
 ISR(TIMER1_COMPA_vect)
 {
+  PROFILE_CORE(PROFILE_ISR_TONE);
   if (timer1_toggle_count != 0)
   {
     // toggle the pin
@@ -537,6 +539,7 @@ ISR(TIMER1_COMPA_vect)
 #ifdef USE_TIMER2
 ISR(TIMER2_COMPA_vect)
 {
+  PROFILE_CORE(PROFILE_ISR_TONE);
 
   if (timer2_toggle_count != 0)
   {
@@ -562,6 +565,7 @@ ISR(TIMER2_COMPA_vect)
 #ifdef USE_TIMER3
 ISR(TIMER3_COMPA_vect)
 {
+  PROFILE_CORE(PROFILE_ISR_TONE);
   if (timer3_toggle_count != 0)
   {
     // toggle the pin
@@ -582,6 +586,7 @@ ISR(TIMER3_COMPA_vect)
 #ifdef USE_TIMER4
 ISR(TIMER4_COMPA_vect)
 {
+  PROFILE_CORE(PROFILE_ISR_TONE);
   if (timer4_toggle_count != 0)
   {
     // toggle the pin
@@ -602,6 +607,7 @@ ISR(TIMER4_COMPA_vect)
 #ifdef USE_TIMER5
 ISR(TIMER5_COMPA_vect)
 {
+  PROFILE_CORE(PROFILE_ISR_TONE);
   if (timer5_toggle_count != 0)
   {
     // toggle the pin
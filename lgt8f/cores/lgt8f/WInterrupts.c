@@ -69,7 +69,14 @@ static volatile voidFuncPtr intFunc[EXTERNAL_NUM_INTERRUPTS] = {
 void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
   if(interruptNum < EXTERNAL_NUM_INTERRUPTS) {
     intFunc[interruptNum] = userFunc;
-    
+    attachInterruptFast(interruptNum, mode);
+  }
+}
+
+// Only sets the trigger and enables the interrupt, the vector itself is
+// bound at compile time with ATTACH_INTERRUPT_FAST(), see Arduino.h.
+void attachInterruptFast(uint8_t interruptNum, int mode) {
+  if(interruptNum < EXTERNAL_NUM_INTERRUPTS) {
     // Configure the interrupt mode (trigger on low input, any change, rising
     // edge, or falling edge).  The mode constants were chosen to correspond
     // to the configuration bits in the hardware register, so we simply shift
@@ -332,8 +339,11 @@ void detachInterrupt(uint8_t interruptNum) {
 }
 
 
+// Weak, so a vector bound with ATTACH_INTERRUPT_FAST() in the sketch
+// replaces the function pointer dispatch of that interrupt.
 #define IMPLEMENT_ISR(vect, interrupt) \
-  ISR(vect) { \
+  ISR(vect, __attribute__((weak))) { \
+    PROFILE_CORE(PROFILE_ISR_INT); \
     intFunc[interrupt](); \
   }
 
@@ -25,6 +25,8 @@ extern "C" {
   #include "stdlib.h"
 }
 
+#include "Arduino.h"
+
 void randomSeed(unsigned long seed)
 {
   if (seed != 0) {
@@ -51,6 +53,16 @@ long random(long howsmall, long howbig)
 
 long map(long x, long in_min, long in_max, long out_min, long out_max)
 {
+#if LGT_UDSC && defined(__LGT8FX8P__)
+  // the usual 10 bit to 8 bit style ranges fit a 16x16 multiply and a 32/16 divide
+  long dx = x - in_min, dy = out_max - out_min, din = in_max - in_min;
+  if (dx == (int16_t)dx && dy == (int16_t)dy && din > 0 && din <= 0xffff) {
+    long p = udscMulS16(dx, dy);
+    if (p < 0)
+      return out_min - (long)udscDiv32(-p, din);
+    return out_min + (long)udscDiv32(p, din);
+  }
+#endif
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
@@ -0,0 +1,85 @@
+/*
+  capture.h - input capture on ICP1/ICP3
+
+  The timer latches its count on each edge at the capture pin in
+  hardware, the capture interrupt only stores the count, extended to 32
+  bit, with the edge in a caller supplied ring buffer. Between edges the
+  CPU is not used at all, and the time of an edge does not depend on
+  what the sketch does. Timestamps are in timer clocks at clk/1, the
+  same counter as cycles() on Timer1: 31.25ns at 32MHz, wrapping after
+  about two minutes; pulseCaptureClock() gives the rate.
+
+  Timer1 captures on ICP1 (D8) and takes the cycles() counter, started
+  here if it does not run yet, so D9/D10 have no pwm. Timer3 (LGT8FX8P)
+  captures on ICP3 and cannot be used with Tickless timekeeping or DDS on
+  Timer3, all of them need the one Timer3 vector. timerFastClock() does
+  not switch a timer while it captures, so pulseCaptureClock() holds for
+  the whole run.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __CAPTURE_H__
+#define __CAPTURE_H__
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#define CAPTURE_TIMER1	1
+#define CAPTURE_TIMER3	3
+
+// or'ed into the mode (RISING, FALLING or CHANGE): the edge has to be
+// stable for four clocks
+#define CAPTURE_NOISE_CANCEL	0x80
+
+// Timer3 is taken by the Tickless timekeeping menu
+#if defined(TIMSK3) && !LGT_TIMER3_MILLIS
+#define __CAPTURE_TIMER3
+#endif
+
+typedef struct {
+	uint32_t time;
+	uint8_t level;		// HIGH after a rising edge, LOW after a falling one
+} capture_edge_t;
+
+uint8_t __captureTimer1Start(uint8_t mode);
+#if defined(__CAPTURE_TIMER3)
+uint8_t __captureTimer3Start(uint8_t mode);
+#endif
+uint8_t __captureSetup(uint8_t timer, capture_edge_t *buf, uint8_t len);
+
+// the buffer holds len - 1 edges, later edges are counted as overruns
+// until the sketch reads
+static inline uint8_t pulseCaptureBegin(uint8_t timer, capture_edge_t *buf, uint8_t len, uint8_t mode)
+{
+	if (!__captureSetup(timer, buf, len))
+		return 0;
+#if defined(__CAPTURE_TIMER3)
+	if (timer == CAPTURE_TIMER3)
+		return __captureTimer3Start(mode);
+#endif
+	return __captureTimer1Start(mode);
+}
+
+void pulseCaptureEnd(uint8_t timer);
+uint8_t pulseCaptureAvailable(uint8_t timer);
+uint8_t pulseCaptureRead(uint8_t timer, capture_edge_t *edge);
+uint16_t pulseCaptureOverruns(uint8_t timer);
+uint32_t pulseCaptureClock(uint8_t timer);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
+
+#endif // __CAPTURE_H__
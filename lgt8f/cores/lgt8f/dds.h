@@ -0,0 +1,90 @@
+/*
+  dds.h - timer driven direct digital synthesis on the internal DAC
+
+  A 16 bit timer in CTC mode interrupts at the sample rate, the interrupt
+  adds the tuning word to a 32 bit phase accumulator and looks the top
+  eight bits up in a 256 entry PROGMEM wavetable. Instead of a wavetable
+  a caller supplied ring buffer of samples can be played out, for
+  waveforms worked out in loop().
+
+  Retuning only replaces the tuning word and switching tables only the
+  table pointer, the phase carries on, so the output has no step or gap.
+
+  The start function of the selected timer is only referenced when the
+  timer argument of ddsBegin() is a constant, so only its interrupt is
+  linked in. Timer1 loses its PWM outputs (D9/D10) while DDS runs, Timer3
+  (LGT8FX8P) shares its interrupt vector with everything else on Timer3
+  and is not available with Tickless timekeeping, which keeps millis()
+  on it; DDS_TIMER3 then runs on Timer1. The sample rate is set from
+  timerClock() at ddsBegin(), timerFastClock() leaves the timer on that
+  clock while DDS runs.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __DDS_H__
+#define __DDS_H__
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#define DDS_TIMER1	1
+#define DDS_TIMER3	3
+
+// Timer3 is taken by the Tickless timekeeping menu
+#if defined(TIMSK3) && !LGT_TIMER3_MILLIS
+#define __DDS_TIMER3
+#endif
+
+// one period of a full scale sine, the default wavetable
+extern const uint8_t ddsSine[256] PROGMEM;
+
+uint8_t __ddsSetup(uint8_t pin);
+uint32_t __ddsTimer1Start(uint32_t rate);
+#if defined(__DDS_TIMER3)
+uint32_t __ddsTimer3Start(uint32_t rate);
+#endif
+
+// starts output on DAC0 (or DAC1 on the LGT8FX8E) at rate samples per
+// second, returns the rate actually set or 0 for a pin without DAC
+static inline uint32_t ddsBegin(uint8_t pin, uint32_t rate, uint8_t timer)
+{
+	if (!__ddsSetup(pin))
+		return 0;
+#if defined(__DDS_TIMER3)
+	if (timer == DDS_TIMER3)
+		return __ddsTimer3Start(rate);
+#endif
+	return __ddsTimer1Start(rate);
+}
+
+void ddsEnd(void);
+uint32_t ddsSampleRate(void);
+void ddsWavetable(const uint8_t *table);
+void ddsTuningWord(uint32_t step);
+uint32_t ddsFrequency(uint32_t hz);
+
+// ring buffer playback, the buffer holds len - 1 samples and the last
+// sample is held when it runs dry; ddsBuffer(0, 0) returns to the table
+uint8_t ddsBuffer(uint8_t *buf, uint8_t len);
+uint8_t ddsWrite(uint8_t val);
+uint8_t ddsAvailableForWrite(void);
+uint16_t ddsUnderruns(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
+
+#endif // __DDS_H__
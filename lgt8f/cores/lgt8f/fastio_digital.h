@@ -49,6 +49,7 @@
 #define _FIO_DDR_24 DDRE
 #define _FIO_DDR_25 DDRE
 #define _FIO_DDR_26 DDRE
+#define _FIO_DDR_27 DDRC
 #endif
 #endif
 
@@ -151,6 +152,7 @@
 #define _FIO_PORT_24 PORTE
 #define _FIO_PORT_25 PORTE
 #define _FIO_PORT_26 PORTE
+#define _FIO_PORT_27 PORTC
 #endif
 #endif
 
@@ -253,6 +255,7 @@
 #define _FIO_PIN_24 PINE
 #define _FIO_PIN_25 PINE
 #define _FIO_PIN_26 PINE
+#define _FIO_PIN_27 PINC
 #endif
 #endif
 
@@ -353,8 +356,9 @@
 #define _FIO_BIT_22  0
 #define _FIO_BIT_23  2
 #define _FIO_BIT_24  4
-#define _FIO_BIT_25  5
-#define _FIO_BIT_26  6
+#define _FIO_BIT_25  6
+#define _FIO_BIT_26  5
+#define _FIO_BIT_27  6
 #endif
 #endif
 
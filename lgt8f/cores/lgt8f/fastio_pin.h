@@ -0,0 +1,304 @@
+/*
+  fastio_pin.h - compile time pins
+  Part of the LGT8Fx core
+
+  Pin<N> looks pin N up in digital_pin_desc[] of the variant at compile
+  time, so each operation is only the register access itself:
+
+	Pin<13>::mode(OUTPUT);	// sbi DDRB
+	Pin<13>::high();	// sbi PORTB
+	Pin<13>::toggle();	// ldi + out PINB (LGT8FX8P)
+	if (Pin<2>::read())	// sbis PIND
+
+  write() with a value that is not a constant costs a branch. Ports out of
+  the I/O space (port E on the LGT8FX8E and LGT8F88A) are read, modified
+  and written back with interrupts off, the same as digitalWrite().
+  mode() hands the pins with side effects in pinMode() (DAC0, E0/E2 SWD
+  and E6 on the LGT8FX8P, and ANALOG) to pinMode(). Unlike digitalWrite()
+  nothing switches pwm off, a pin with analogWrite() running needs
+  digitalWrite() once.
+
+  PinGroup<P0, P1, ...> handles up to 16 pins as a word, pin P0 is bit 0.
+  write() does one read-modify-write per port the pins are on, with
+  interrupts off, so the pins of a port change together.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __FASTIO_PIN_H__
+#define __FASTIO_PIN_H__
+
+#ifdef __cplusplus
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define __PIN_ALWAYS_INLINE	static inline __attribute__((always_inline))
+
+// registers of a port, numbered PB..PF as in digital_pin_desc[]; io is
+// set when the port is in the I/O space, where sbi/cbi work
+template <uint8_t P> struct __PinPort;
+
+#define __PIN_PORT(n, x, isio) \
+	template <> struct __PinPort<n> { \
+		static constexpr bool io = isio; \
+		__PIN_ALWAYS_INLINE volatile uint8_t &ddr() { return DDR##x; } \
+		__PIN_ALWAYS_INLINE volatile uint8_t &port() { return PORT##x; } \
+		__PIN_ALWAYS_INLINE volatile uint8_t &pin() { return PIN##x; } \
+	}
+
+__PIN_PORT(2, B, true);
+__PIN_PORT(3, C, true);
+__PIN_PORT(4, D, true);
+#if defined(__LGT8FX8P__) && !defined(USE_EIO_EREG)
+__PIN_PORT(5, E, true);
+#define __PIN_PORT_END	6
+#elif defined(PORTE)
+__PIN_PORT(5, E, false);
+#define __PIN_PORT_END	6
+#else
+#define __PIN_PORT_END	5
+#endif
+#if defined(__LGT8FX8P48__)
+__PIN_PORT(6, F, true);
+#undef __PIN_PORT_END
+#define __PIN_PORT_END	7
+#endif
+
+// pins pinMode() does more for than DDR and PORT
+constexpr bool __pinModeSpecial(uint8_t n)
+{
+#if defined(__LGT8FX8P__)
+	return n == DAC0 || n == E0 || n == E2 || n == E6;
+#else
+	return false;
+#endif
+}
+
+template <uint8_t N>
+class Pin {
+	static_assert(N < sizeof(digital_pin_desc), "Pin<N>: not a digital pin of this variant");
+
+public:
+	static constexpr uint8_t port = digital_pin_desc[N] >> 4;
+	static constexpr uint8_t bit = digital_pin_desc[N] & 0x0f;
+	static constexpr uint8_t mask = 1 << bit;
+
+	typedef __PinPort<port> reg;
+
+	__PIN_ALWAYS_INLINE void mode(uint8_t mode)
+	{
+		if (__pinModeSpecial(N) || mode == ANALOG || !reg::io) {
+			pinMode(N, mode);
+		} else if (mode == OUTPUT) {
+			reg::ddr() |= mask;
+		} else {
+			reg::ddr() &= ~mask;
+			if (mode == INPUT_PULLUP)
+				reg::port() |= mask;
+			else
+				reg::port() &= ~mask;
+		}
+	}
+
+	__PIN_ALWAYS_INLINE void high()
+	{
+		if (reg::io) {
+			reg::port() |= mask;
+		} else {
+			uint8_t oldSREG = SREG;
+			cli();
+			reg::port() |= mask;
+			SREG = oldSREG;
+		}
+	}
+
+	__PIN_ALWAYS_INLINE void low()
+	{
+		if (reg::io) {
+			reg::port() &= ~mask;
+		} else {
+			uint8_t oldSREG = SREG;
+			cli();
+			reg::port() &= ~mask;
+			SREG = oldSREG;
+		}
+	}
+
+	__PIN_ALWAYS_INLINE void write(uint8_t val)
+	{
+		if (val)
+			high();
+		else
+			low();
+	}
+
+	// a one written to PINx toggles the output on the LGT8FX8P, see
+	// digitalToggle()
+	__PIN_ALWAYS_INLINE void toggle()
+	{
+#if defined(__LGT8FX8P__)
+		reg::pin() = mask;
+#else
+		uint8_t oldSREG = SREG;
+		cli();
+		reg::port() ^= mask;
+		SREG = oldSREG;
+#endif
+	}
+
+	__PIN_ALWAYS_INLINE uint8_t read()
+	{
+		return (reg::pin() & mask) ? HIGH : LOW;
+	}
+};
+
+template <uint8_t... P> struct __PinList;
+
+template <> struct __PinList<> {
+	static constexpr uint8_t mask(uint8_t) { return 0; }
+	__PIN_ALWAYS_INLINE void modeSpecial(uint8_t) {}
+	__PIN_ALWAYS_INLINE uint8_t bits(uint8_t, uint16_t) { return 0; }
+	__PIN_ALWAYS_INLINE uint16_t collect(const uint8_t *) { return 0; }
+};
+
+template <uint8_t P, uint8_t... R> struct __PinList<P, R...> {
+	// pins of the list on port
+	static constexpr uint8_t mask(uint8_t port)
+	{
+		return (Pin<P>::port == port ? Pin<P>::mask : 0) | __PinList<R...>::mask(port);
+	}
+
+	__PIN_ALWAYS_INLINE void modeSpecial(uint8_t mode)
+	{
+		if (__pinModeSpecial(P) || mode == ANALOG)
+			pinMode(P, mode);
+		__PinList<R...>::modeSpecial(mode);
+	}
+
+	// port bits for the group value val
+	__PIN_ALWAYS_INLINE uint8_t bits(uint8_t port, uint16_t val)
+	{
+		return ((Pin<P>::port == port && (val & 1)) ? Pin<P>::mask : 0) |
+			__PinList<R...>::bits(port, val >> 1);
+	}
+
+	// group value from the input registers, in[] indexed by port - PB
+	__PIN_ALWAYS_INLINE uint16_t collect(const uint8_t *in)
+	{
+		return ((in[Pin<P>::port - 2] & Pin<P>::mask) ? 1 : 0) |
+			(__PinList<R...>::collect(in) << 1);
+	}
+};
+
+// walks the ports from PB on, code is only left for ports with pins
+template <uint8_t Port, uint8_t... P> struct __PinGroupPort {
+	typedef __PinPort<Port> reg;
+	typedef __PinGroupPort<Port + 1, P...> next;
+	static constexpr uint8_t mask = __PinList<P...>::mask(Port);
+
+	__PIN_ALWAYS_INLINE void mode(uint8_t mode)
+	{
+		if (mask) {
+			uint8_t oldSREG = SREG;
+			cli();
+			if (mode == OUTPUT) {
+				reg::ddr() |= mask;
+			} else {
+				reg::ddr() &= ~mask;
+				if (mode == INPUT_PULLUP)
+					reg::port() |= mask;
+				else
+					reg::port() &= ~mask;
+			}
+			SREG = oldSREG;
+		}
+		next::mode(mode);
+	}
+
+	__PIN_ALWAYS_INLINE void write(uint16_t val)
+	{
+		if (mask) {
+			uint8_t bits = __PinList<P...>::bits(Port, val);
+			uint8_t oldSREG = SREG;
+			cli();
+			reg::port() = (reg::port() & ~mask) | bits;
+			SREG = oldSREG;
+		}
+		next::write(val);
+	}
+
+	__PIN_ALWAYS_INLINE void toggle()
+	{
+		if (mask) {
+#if defined(__LGT8FX8P__)
+			reg::pin() = mask;
+#else
+			uint8_t oldSREG = SREG;
+			cli();
+			reg::port() ^= mask;
+			SREG = oldSREG;
+#endif
+		}
+		next::toggle();
+	}
+
+	__PIN_ALWAYS_INLINE void sample(uint8_t *in)
+	{
+		if (mask)
+			in[Port - 2] = reg::pin();
+		next::sample(in);
+	}
+};
+
+template <uint8_t... P> struct __PinGroupPort<__PIN_PORT_END, P...> {
+	__PIN_ALWAYS_INLINE void mode(uint8_t) {}
+	__PIN_ALWAYS_INLINE void write(uint16_t) {}
+	__PIN_ALWAYS_INLINE void toggle() {}
+	__PIN_ALWAYS_INLINE void sample(uint8_t *) {}
+};
+
+template <uint8_t... P>
+class PinGroup {
+	static_assert(sizeof...(P) >= 1 && sizeof...(P) <= 16, "PinGroup: 1 to 16 pins");
+
+	typedef __PinGroupPort<2, P...> ports;
+
+public:
+	// the special pins of Pin<N>::mode() go to pinMode() as well
+	__PIN_ALWAYS_INLINE void mode(uint8_t mode)
+	{
+		if (mode != ANALOG)
+			ports::mode(mode);
+		__PinList<P...>::modeSpecial(mode);
+	}
+
+	__PIN_ALWAYS_INLINE void write(uint16_t val)
+	{
+		ports::write(val);
+	}
+
+	__PIN_ALWAYS_INLINE void toggle()
+	{
+		ports::toggle();
+	}
+
+	// each port is read once, so the pins of a port are sampled together
+	__PIN_ALWAYS_INLINE uint16_t read()
+	{
+		uint8_t in[__PIN_PORT_END - 2];
+
+		ports::sample(in);
+		return __PinList<P...>::collect(in);
+	}
+};
+
+#undef __PIN_PORT
+
+#endif // __cplusplus
+
+#endif // __FASTIO_PIN_H__
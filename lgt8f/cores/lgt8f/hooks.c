@@ -16,16 +16,20 @@
   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+// only resolved when a sketch uses the scheduler (scheduler.c)
+extern void schedulerRun(void) __attribute__((weak));
+
 /**
- * Empty yield() hook.
+ * Default yield() hook.
  *
  * This function is intended to be used by library writers to build
  * libraries or sketches that supports cooperative threads.
  *
  * Its defined as a weak symbol and it can be redefined to implement a
- * real cooperative scheduler.
+ * real cooperative scheduler. By default it runs the expired tasks of
+ * the core scheduler, so they are serviced during delay().
  */
 static void __empty() {
-	// Empty
+	if (schedulerRun) schedulerRun();
 }
 void yield(void) __attribute__ ((weak, alias("__empty")));
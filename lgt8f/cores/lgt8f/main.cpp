@@ -214,6 +214,7 @@ int main(void)
 	for (;;) {
 		loop();
 		if (serialEventRun) serialEventRun();
+		if (schedulerRun) schedulerRun();
 	}
         
 	return 0;
@@ -0,0 +1,77 @@
+/*
+  parallel_bus.h - 8/16 bit parallel buses on any pins
+
+  parallelBusBegin() takes the pins of a bus, bit 0 first, and works out
+  once per port which pins belong to it. A port whose pins all sit at
+  the same offset from their word bit (D0..D7 on PD0..PD7, or a nibble
+  moved up by four) is written with one shift and mask; only the other
+  ports go through a per bit table. Each word is then one read-modify-
+  write per port, or a plain write where the bus owns the whole port,
+  followed by a pulse on the optional strobe pin, all with interrupts
+  off so a word goes out in one piece.
+
+  The buffer functions write bursts from RAM or PROGMEM, one byte per
+  word for buses up to 8 bit, two (low byte first) above.
+
+  Pins that pinMode() has to turn into GPIO first (DAC0, E0/E2 SWD and
+  E6 on the LGT8FX8P) go through pinMode() once in parallelBusBegin(),
+  parallelBusMode() then only switches DDR and PORT.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __PARALLEL_BUS_H__
+#define __PARALLEL_BUS_H__
+
+#include <stdint.h>
+#include "pin_handle.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#define PARALLEL_BUS_PORTS	5
+#define PARALLEL_BUS_WIDTH	16
+
+#define PARALLEL_NO_STROBE	0xff
+
+// strobe pulse: data is taken on the rising edge of a low pulse (8080
+// style WR) or on a high pulse (latch enable)
+#define PARALLEL_STROBE_LOW	0
+#define PARALLEL_STROBE_HIGH	1
+
+#define __PARALLEL_PERMUTED	0x7f
+
+typedef struct {
+	uint8_t in;		// PINx address, DDRx and PORTx follow
+	uint8_t mask;		// bus pins on the port
+	int8_t shift;		// word bit - port bit, or __PARALLEL_PERMUTED
+} __parallel_port_t;
+
+typedef struct {
+	__parallel_port_t port[PARALLEL_BUS_PORTS];
+	uint8_t nports;
+	uint8_t width;
+	uint8_t permuted;	// set when a port uses the tables below
+	uint8_t bit_port[PARALLEL_BUS_WIDTH];	// port[] index of each word bit
+	uint8_t bit_mask[PARALLEL_BUS_WIDTH];	// port bit of each word bit
+	pinHandle strobe;
+	uint8_t strobe_active;
+} parallel_bus_t;
+
+uint8_t parallelBusBegin(parallel_bus_t *bus, const uint8_t *pins, uint8_t width, uint8_t strobe, uint8_t active);
+void parallelBusMode(parallel_bus_t *bus, uint8_t mode);
+void parallelBusWrite(parallel_bus_t *bus, uint16_t val);
+uint16_t parallelBusRead(parallel_bus_t *bus);
+void parallelBusStrobe(parallel_bus_t *bus);
+void parallelBusWriteBuffer(parallel_bus_t *bus, const void *buf, uint16_t len);
+void parallelBusWriteBuffer_P(parallel_bus_t *bus, const void *buf, uint16_t len);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // __PARALLEL_BUS_H__
@@ -0,0 +1,90 @@
+/*
+  pcint.h - pin change interrupts on any pin
+
+  The core owns the PCINTn vectors, one per port, so libraries and the
+  sketch share them instead of each claiming whole vectors. Every pin
+  gets its own callback and edge:
+
+	void onEdge(uint8_t level) { ... }
+	attachPinChangeInterrupt(pin, onEdge, FALLING);
+
+  The vector reads the port once, XORs it with the state of the last
+  interrupt of that port to find which pins changed and in which
+  direction, and calls the callbacks of the pins whose edge matches,
+  lowest bit first, with the level read on entry. Callbacks run inside
+  the interrupt. A pin that goes back before the vector reads the port
+  shows no change; such pulses need INT0/INT1 or input capture.
+
+  pinChangeInterruptMask() pauses a pin without giving up its callback;
+  a callback that masks its own pin in the PCMSKn register directly
+  unmasks it with __pcintUnmask() so the next edge is measured against
+  the current level.
+
+  Where the dispatch is too slow, pinChangeInterruptHook() puts one
+  function at the head of the vector of a pin's port, about
+  PCINT_HOOK_CYCLES later than a vector of its own would call it,
+  whatever the bit. It runs on every interrupt of the port, before the
+  port is read and outside the profiler, and has to check its pin and
+  set its own PCMSKn bit. SoftwareSerial receives its start bit there.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __PCINT_H__
+#define __PCINT_H__
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// one group per port, from PB: PCINT0 (PB) .. PCINT4 (PF)
+#if defined(PCINT4_vect)
+#define PCINT_GROUPS	5
+#elif defined(PCINT3_vect)
+#define PCINT_GROUPS	4
+#else
+#define PCINT_GROUPS	3
+#endif
+
+// clocks from the vector to the first instruction of the callback of
+// bit 0 of a group with no hook set, each further bit scanned adds
+// about 5; the profiler reads cycles() and keeps it in saved registers
+// ahead of the dispatch
+#if LGT_PROFILE
+#define PCINT_DISPATCH_CYCLES	72
+#else
+#define PCINT_DISPATCH_CYCLES	52
+#endif
+
+// the load, test and indirect call of the hook and the registers it
+// saves for the call
+#define PCINT_HOOK_CYCLES	12
+
+typedef void (*pcintFunc)(uint8_t level);
+typedef void (*pcintHook)(void);
+
+uint8_t attachPinChangeInterrupt(uint8_t pin, pcintFunc func, uint8_t mode);
+void detachPinChangeInterrupt(uint8_t pin);
+void pinChangeInterruptMask(uint8_t pin, uint8_t enable);
+uint8_t pinChangeInterruptHook(uint8_t pin, pcintHook hook);
+
+extern volatile uint8_t __pcint_last[PCINT_GROUPS];
+
+// interrupts are off
+static inline void __pcintUnmask(uint8_t group, volatile uint8_t *pcmsk, volatile uint8_t *in, uint8_t mask)
+{
+	__pcint_last[group] = (__pcint_last[group] & ~mask) | (*in & mask);
+	*pcmsk |= mask;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // __PCINT_H__
@@ -0,0 +1,83 @@
+/*
+  pin_handle.h - resolved pins for runtime pin numbers
+
+  pinResolve() looks a pin up once and switches its pwm off, the same as
+  digitalWrite() does on every call. The handle it returns carries the
+  input register address and the bit mask, so pinWrite(), pinRead() and
+  pinToggle() are only the register access, for pin numbers that come
+  from a table or a variable:
+
+	pinHandle led = pinResolve(pin);
+	pinWrite(led, HIGH);
+
+  PINx, DDRx and PORTx of every port are at consecutive addresses below
+  0x100, so one byte holds them all. A pin that does not exist resolves
+  to a handle with no bits, writes and reads on it do nothing. Starting
+  pwm on the pin again with analogWrite() needs a new pinResolve().
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __PIN_HANDLE_H__
+#define __PIN_HANDLE_H__
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// PINx address in the low byte, bit mask in the high byte
+typedef uint16_t pinHandle;
+
+#define PIN_HANDLE_NONE	((pinHandle)(uint8_t)(uint16_t)&PINB)
+
+#define __pinHandleIn(h)	((volatile uint8_t *)(uint16_t)(uint8_t)(h))
+#define __pinHandleOut(h)	((volatile uint8_t *)(uint16_t)((uint8_t)(h) + 2))
+#define __pinHandleMask(h)	((uint8_t)((h) >> 8))
+
+pinHandle pinResolve(uint8_t pin);
+
+static inline void pinWrite(pinHandle h, uint8_t val)
+{
+	volatile uint8_t *out = __pinHandleOut(h);
+	uint8_t mask = __pinHandleMask(h);
+	uint8_t oldSREG = SREG;
+
+	cli();
+	if (val)
+		*out |= mask;
+	else
+		*out &= ~mask;
+	SREG = oldSREG;
+}
+
+static inline uint8_t pinRead(pinHandle h)
+{
+	return (*__pinHandleIn(h) & __pinHandleMask(h)) ? 1 : 0;
+}
+
+static inline void pinToggle(pinHandle h)
+{
+#if defined(__LGT8FX8P__)
+	*__pinHandleIn(h) = __pinHandleMask(h);
+#else
+	volatile uint8_t *out = __pinHandleOut(h);
+	uint8_t oldSREG = SREG;
+
+	cli();
+	*out ^= __pinHandleMask(h);
+	SREG = oldSREG;
+#endif
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // __PIN_HANDLE_H__
@@ -0,0 +1,129 @@
+/*
+  profile.cpp - scoped profiler table
+  Part of the LGT8Fx core
+
+  Entries are updated with interrupts held off, so scopes in interrupts
+  and in the main line may share an id. A scope that is interrupted also
+  counts the time spent in the interrupt.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "Arduino.h"
+
+profile_entry_t __profile_table[PROFILE_MAX];
+
+static const char profile_names[] PROGMEM =
+	"digitalWrite\0analogRead\0Serial.write\0printNumber\0"
+	"ISR millis\0ISR serial rx\0ISR serial tx\0"
+	"ISR int\0ISR pcint\0ISR twi\0ISR tone\0";
+
+void profileRecord(uint8_t id, uint32_t elapsed)
+{
+	__profileRecord(id, elapsed);
+}
+
+void profileReset(void)
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	memset(__profile_table, 0, sizeof(__profile_table));
+	SREG = oldSREG;
+}
+
+// consistent copy of one entry, returns 0 when it was never recorded
+uint8_t profileGet(uint8_t id, profile_entry_t *entry)
+{
+	uint8_t oldSREG = SREG;
+
+	if (id >= PROFILE_MAX) {
+		memset(entry, 0, sizeof(*entry));
+		return 0;
+	}
+
+	cli();
+	*entry = __profile_table[id];
+	SREG = oldSREG;
+
+	return entry->count != 0;
+}
+
+// one line per used entry: id, name, count, min, max, average and total
+void profileDump(Print &out)
+{
+	profile_entry_t e;
+	const char *name = profile_names;
+	uint8_t id, oldSREG;
+
+	out.println(F("id\tcount\tmin\tmax\tavg\ttotal\tname"));
+
+	for (id = 0; id < PROFILE_MAX; id++) {
+		oldSREG = SREG;
+		cli();
+		e = __profile_table[id];
+		SREG = oldSREG;
+
+		if (e.count) {
+			out.print(id);
+			out.print('\t');
+			out.print(e.count);
+			out.print('\t');
+			out.print(e.min);
+			out.print('\t');
+			out.print(e.max);
+			out.print('\t');
+			out.print(e.total / e.count);
+			out.print('\t');
+			out.print(e.total);
+			out.print('\t');
+			if (id < PROFILE_USER && pgm_read_byte(name))
+				out.print((const __FlashStringHelper *)name);
+			out.println();
+		}
+
+		// step to the next name, the list ends with an empty one
+		if (id < PROFILE_USER && pgm_read_byte(name))
+			name += strlen_P(name) + 1;
+	}
+}
+
+static uint8_t dumpBytes(Print &out, const void *buf, uint8_t len, uint8_t sum)
+{
+	const uint8_t *b = (const uint8_t *)buf;
+
+	out.write(b, len);
+	while (len--)
+		sum ^= *b++;
+
+	return sum;
+}
+
+// see profile.h for the format, the table is little endian already
+void profileDumpBinary(Print &out)
+{
+	profile_entry_t e;
+	uint8_t id, n = 0, sum;
+
+	for (id = 0; id < PROFILE_MAX; id++)
+		if (__profile_table[id].count)
+			n++;
+
+	sum = PROFILE_DUMP_MAGIC;
+	out.write(sum);
+	sum = dumpBytes(out, &n, 1, sum);
+
+	// an entry recorded after the count above is left for the next dump
+	for (id = 0; id < PROFILE_MAX && n; id++) {
+		if (!profileGet(id, &e))
+			continue;
+		sum = dumpBytes(out, &id, 1, sum);
+		sum = dumpBytes(out, &e, sizeof(e), sum);
+		n--;
+	}
+
+	out.write(sum);
+}
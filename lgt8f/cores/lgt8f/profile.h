@@ -0,0 +1,168 @@
+/*
+  profile.h - cycle counter and scoped profiler
+
+  cycles() reads a free running 32 bit count of Timer1 clocks, TCNT1 at
+  clk/1 below and a 16 bit overflow count above it. cyclesBegin() takes
+  Timer1 for that, so D9/D10 have no pwm while it runs, and keeps it on
+  the system clock whatever timerFastClock() asks for, so the count is
+  in CPU clocks.
+
+  PROFILE_SCOPE(id) times the rest of the enclosing block and adds it to
+  entry id of a table in SRAM (count, min, max and total cycles). The
+  time is recorded when the block is left by any path, return included,
+  through the cleanup attribute, so it works the same in C and C++.
+
+  With the "Profiler" board menu on, cyclesBegin() is called from init()
+  and the core times digitalWrite(), analogRead(), Serial.write(),
+  Print::printNumber() and its own interrupts under the PROFILE_* ids
+  below the PROFILE_USER range: Timer0 overflow, Serial rx and tx,
+  INT0/INT1 through attachInterrupt(), pin change dispatch, Wire and
+  tone(). SoftwareSerial receives in the hook ahead of the profiled
+  dispatch, so its timing and baud limits do not change with the
+  profiler on, and its time is not in the pin change entry. Each
+  interrupt entry then holds its call count, worst case and total time,
+  so the share of the CPU an interrupt takes is total / cycles(). A
+  profiled interrupt reads cycles() on entry and again on exit, where
+  the record is inlined into it, so only the registers it uses are
+  saved: counted by instruction, about 20 clocks on entry and 90 on
+  exit, most of it the loads and stores of the 32 bit fields of the
+  entry.
+
+  profileGet() copies one entry out, profileDumpBinary() sends the whole
+  table in a compact form for a host to decode: 0xa5, the number of
+  used entries, then per entry the id and count, min, max and total as
+  32 bit little endian, and last the XOR of all bytes before it.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// set from the "Profiler" board menu, instruments the core
+#ifndef LGT_PROFILE
+#define LGT_PROFILE 0
+#endif
+
+// entries in the profile table, 16 bytes of SRAM each
+#ifndef PROFILE_MAX
+#define PROFILE_MAX	20
+#endif
+
+#define PROFILE_DIGITAL_WRITE	0
+#define PROFILE_ANALOG_READ	1
+#define PROFILE_SERIAL_WRITE	2
+#define PROFILE_PRINT_NUMBER	3
+#define PROFILE_ISR_MILLIS	4
+#define PROFILE_ISR_SERIAL_RX	5
+#define PROFILE_ISR_SERIAL_TX	6
+#define PROFILE_ISR_INT		7
+#define PROFILE_ISR_PCINT	8
+#define PROFILE_ISR_TWI		9
+#define PROFILE_ISR_TONE	10
+#define PROFILE_USER		12
+
+#define PROFILE_DUMP_MAGIC	0xa5
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+extern volatile uint16_t __cycles_overflow;
+
+void cyclesBegin(void);
+void cyclesEnd(void);
+
+static inline uint32_t cycles(void)
+{
+	uint16_t hi, lo;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	hi = __cycles_overflow;
+	lo = TCNT1;
+	// an overflow the interrupt has not counted yet
+	if ((TIFR1 & _BV(TOV1)) && (lo < 0x8000))
+		hi++;
+	SREG = oldSREG;
+
+	return ((uint32_t)hi << 16) | lo;
+}
+
+typedef struct {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint32_t total;
+} profile_entry_t;
+
+extern profile_entry_t __profile_table[PROFILE_MAX];
+
+void profileRecord(uint8_t id, uint32_t elapsed);
+void profileReset(void);
+uint8_t profileGet(uint8_t id, profile_entry_t *entry);
+
+// inline so a scope in an interrupt saves only the registers it uses
+// instead of all call-clobbered ones; with a constant id the entry
+// address is a constant too
+static inline void __profileRecord(uint8_t id, uint32_t elapsed) \
+	__attribute__((always_inline));
+static inline void __profileRecord(uint8_t id, uint32_t elapsed)
+{
+	profile_entry_t *e = &__profile_table[id];
+	uint8_t oldSREG = SREG;
+
+	if (id >= PROFILE_MAX)
+		return;
+
+	cli();
+	if (elapsed > e->max)
+		e->max = elapsed;
+	if (elapsed < e->min || e->count == 0)
+		e->min = elapsed;
+	e->total += elapsed;
+	e->count++;
+	SREG = oldSREG;
+}
+
+typedef struct {
+	uint32_t start;
+	uint8_t id;
+} __profile_scope_t;
+
+static inline void __profileLeave(__profile_scope_t *scope) \
+	__attribute__((always_inline));
+static inline void __profileLeave(__profile_scope_t *scope)
+{
+	__profileRecord(scope->id, cycles() - scope->start);
+}
+
+#define __PROFILE_NAME2(line)	__profile_scope_##line
+#define __PROFILE_NAME(line)	__PROFILE_NAME2(line)
+
+#define PROFILE_SCOPE(id) \
+	__profile_scope_t __PROFILE_NAME(__LINE__) \
+		__attribute__((cleanup(__profileLeave))) = { cycles(), (id) }
+
+#if LGT_PROFILE
+#define PROFILE_CORE(id)	PROFILE_SCOPE(id)
+#else
+#define PROFILE_CORE(id)
+#endif
+
+#ifdef __cplusplus
+} // extern "C"
+
+class Print;
+void profileDump(Print &out);
+void profileDumpBinary(Print &out);
+#endif
+
+#endif // __PROFILE_H__
@@ -0,0 +1,173 @@
+/*
+  scheduler.c - cooperative timer wheel scheduler
+  Part of the LGT8Fx core
+
+  Tasks are kept in a wheel of SCHED_SLOTS lists indexed by the low bits
+  of their due time in milliseconds. Adding or cancelling a task is a
+  constant time list operation, and every millisecond that passes only
+  visits one slot, where tasks due in a later round of the wheel are
+  skipped over.
+
+  schedulerRun() catches the wheel up with millis() and runs what has
+  expired. It is called after every loop() and from yield(), so tasks
+  keep running while the sketch sits in delay(). Tasks run in the main
+  line, never from an interrupt, and a task that calls delay() itself
+  does not start other tasks meanwhile.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+
+#define SCHED_SLOTS	16
+
+static sched_task_t *sched_wheel[SCHED_SLOTS];
+static uint32_t sched_tick;	// next millisecond to visit
+static uint8_t sched_started;
+static uint8_t sched_busy;
+
+static void schedLink(sched_task_t *t)
+{
+	sched_task_t **head;
+
+	// a task due before the wheel position goes into the next slot
+	// visited, not a full turn later
+	if ((long)(t->due - sched_tick) < 0)
+		head = &sched_wheel[sched_tick & (SCHED_SLOTS - 1)];
+	else
+		head = &sched_wheel[t->due & (SCHED_SLOTS - 1)];
+
+	t->next = *head;
+	if (t->next)
+		t->next->pprev = &t->next;
+	t->pprev = head;
+	*head = t;
+}
+
+static void schedUnlink(sched_task_t *t)
+{
+	*t->pprev = t->next;
+	if (t->next)
+		t->next->pprev = t->pprev;
+	t->pprev = 0;
+}
+
+static void schedFire(sched_task_t *t, uint32_t now)
+{
+	uint32_t late = now - t->due;
+	uint32_t start, run;
+
+	schedUnlink(t);
+
+	t->runs++;
+	if (late) {
+		if (t->late != 0xffff)
+			t->late++;
+		if (late > t->max_late)
+			t->max_late = (late > 0xffff) ? 0xffff : late;
+	}
+
+	// linked again before it runs, so the task may cancel or re-add itself
+	if (t->period) {
+		do {
+			t->due += t->period;
+		} while ((long)(t->due - now) <= 0);
+		schedLink(t);
+	}
+
+	start = micros();
+	t->func();
+	run = micros() - start;
+
+	if (run > t->max_run)
+		t->max_run = run;
+	if (t->period && run >= t->period * 1000UL && t->overruns != 0xffff)
+		t->overruns++;
+}
+
+void schedulerAdd(sched_task_t *task, void (*func)(void), uint32_t delay, uint32_t period)
+{
+	if (task->pprev)
+		schedUnlink(task);
+
+	if (!sched_started) {
+		sched_tick = millis();
+		sched_started = 1;
+	}
+
+	memset(task, 0, sizeof(*task));
+	task->func = func;
+	task->period = period;
+	task->due = millis() + delay;
+	schedLink(task);
+}
+
+void schedulerCancel(sched_task_t *task)
+{
+	if (task->pprev)
+		schedUnlink(task);
+}
+
+uint8_t schedulerPending(sched_task_t *task)
+{
+	return task->pprev != 0;
+}
+
+// milliseconds until the next task is due, 0 when one is due now and
+// 0xffffffff without tasks; for idleSleep() in loop()
+uint32_t schedulerIdleTime(void)
+{
+	sched_task_t *t;
+	uint32_t now = millis();
+	uint32_t idle = 0xffffffffUL;
+	uint8_t slot;
+
+	for (slot = 0; slot < SCHED_SLOTS; slot++) {
+		for (t = sched_wheel[slot]; t; t = t->next) {
+			if ((long)(t->due - now) <= 0)
+				return 0;
+			if (t->due - now < idle)
+				idle = t->due - now;
+		}
+	}
+
+	return idle;
+}
+
+void schedulerRun(void)
+{
+	sched_task_t *t;
+	uint32_t now;
+	uint8_t slot;
+
+	if (sched_busy || !sched_started)
+		return;
+	sched_busy = 1;
+
+	now = millis();
+
+	// after a long stall every slot is visited once
+	if ((long)(now - sched_tick) >= SCHED_SLOTS)
+		sched_tick = now - (SCHED_SLOTS - 1);
+
+	while ((long)(now - sched_tick) >= 0) {
+		slot = sched_tick & (SCHED_SLOTS - 1);
+
+		// a task may change the slot it runs from, start over after each
+		t = sched_wheel[slot];
+		while (t) {
+			if ((long)(t->due - now) <= 0) {
+				schedFire(t, now);
+				t = sched_wheel[slot];
+			} else {
+				t = t->next;
+			}
+		}
+		sched_tick++;
+	}
+
+	sched_busy = 0;
+}
@@ -0,0 +1,169 @@
+/*
+  udsc.h - helpers for the LGT8FX8P uDSC computation accelerator
+
+  The uDSC is a 16x16 multiplier/accumulator with a 32/16 divider that
+  sits on the I/O bus (DSCR/DSIR, DX/DY operands, 32 bit accumulator
+  DA = DSAH:DSAL). Operands are moved with a single 16 bit in/out on an
+  even register pair, so the transfers are written in inline asm.
+
+  Every helper loads all of its operands, runs one instruction and reads
+  the result back with interrupts held off, so the unit carries no state
+  between calls and may be used from ISRs and from the main line alike.
+  DSUEN has to be set once before use, see udscBegin().
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#ifndef __UDSC_H__
+#define __UDSC_H__
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// set from the "uDSC arithmetic" board menu, routes core math through the unit
+#ifndef LGT_UDSC
+#define LGT_UDSC 0
+#endif
+
+#if defined(__LGT8FX8P__)
+
+// DSIR instruction codes (databook, "uDSC instruction set")
+#define UDSC_OP_MUL	0x44	// DA = DX * DY (unsigned)
+#define UDSC_OP_MULS	0x74	// DA = DX * DY (signed)
+#define UDSC_OP_MAC	0x46	// DA = DA + DX * DY (unsigned)
+#define UDSC_OP_MACS	0x76	// DA = DA + DX * DY (signed)
+#define UDSC_OP_DIVMOD	0xb1	// DA = DA / DY, DY = DA % DY (unsigned 32/16)
+
+#define UDSC_IS_POW2(x)	(((x) & ((x) - 1)) == 0)
+
+static inline void udscBegin(void)
+{
+	DSCR = _BV(DSUEN);
+}
+
+static inline void udscEnd(void)
+{
+	DSCR = 0;
+}
+
+static inline uint32_t __udsc_mul(uint8_t op, uint16_t x, uint16_t y)
+{
+	uint32_t r;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	__asm__ __volatile__ (
+		"out %[dx], %A[x]"	"\n\t"
+		"out %[dy], %A[y]"	"\n\t"
+		"out %[ir], %[op]"	"\n\t"
+		"in  %A[r], %[al]"	"\n\t"
+		"in  %C[r], %[ah]"	"\n\t"
+		: [r] "=&r" (r)
+		: [x] "r" (x), [y] "r" (y), [op] "r" (op),
+		  [dx] "I" (_SFR_IO_ADDR(DSDX)), [dy] "I" (_SFR_IO_ADDR(DSDY)),
+		  [ir] "I" (_SFR_IO_ADDR(DSIR)),
+		  [al] "I" (_SFR_IO_ADDR(DSAL)), [ah] "I" (_SFR_IO_ADDR(DSAH))
+	);
+	SREG = oldSREG;
+
+	return r;
+}
+
+static inline uint32_t __udsc_mac(uint8_t op, uint32_t acc, uint16_t x, uint16_t y)
+{
+	uint32_t r;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	__asm__ __volatile__ (
+		"out %[al], %A[a]"	"\n\t"
+		"out %[ah], %C[a]"	"\n\t"
+		"out %[dx], %A[x]"	"\n\t"
+		"out %[dy], %A[y]"	"\n\t"
+		"out %[ir], %[op]"	"\n\t"
+		"in  %A[r], %[al]"	"\n\t"
+		"in  %C[r], %[ah]"	"\n\t"
+		: [r] "=&r" (r)
+		: [a] "r" (acc), [x] "r" (x), [y] "r" (y), [op] "r" (op),
+		  [dx] "I" (_SFR_IO_ADDR(DSDX)), [dy] "I" (_SFR_IO_ADDR(DSDY)),
+		  [ir] "I" (_SFR_IO_ADDR(DSIR)),
+		  [al] "I" (_SFR_IO_ADDR(DSAL)), [ah] "I" (_SFR_IO_ADDR(DSAH))
+	);
+	SREG = oldSREG;
+
+	return r;
+}
+
+static inline uint32_t udscMul16(uint16_t x, uint16_t y)
+{
+	return __udsc_mul(UDSC_OP_MUL, x, y);
+}
+
+static inline int32_t udscMulS16(int16_t x, int16_t y)
+{
+	return (int32_t)__udsc_mul(UDSC_OP_MULS, x, y);
+}
+
+static inline uint32_t udscMac16(uint32_t acc, uint16_t x, uint16_t y)
+{
+	return __udsc_mac(UDSC_OP_MAC, acc, x, y);
+}
+
+static inline int32_t udscMacS16(int32_t acc, int16_t x, int16_t y)
+{
+	return (int32_t)__udsc_mac(UDSC_OP_MACS, acc, x, y);
+}
+
+// low 32 bits of a 32x16 product, as the C multiply would give
+static inline uint32_t udscMul32x16(uint32_t x, uint16_t y)
+{
+	uint32_t hi = udscMul16(x >> 16, y);
+
+	return udscMul16(x, y) + (hi << 16);
+}
+
+// 32/16 unsigned divide, the remainder is stored through rem when not NULL.
+// The divider needs 7 cycles before DA/DY are valid. d must not be zero.
+static inline uint32_t udscDivMod32(uint32_t n, uint16_t d, uint16_t *rem)
+{
+	uint32_t q;
+	uint16_t r;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	__asm__ __volatile__ (
+		"out %[al], %A[n]"	"\n\t"
+		"out %[ah], %C[n]"	"\n\t"
+		"out %[dy], %A[d]"	"\n\t"
+		"out %[ir], %[op]"	"\n\t"
+		"rjmp .+0"		"\n\t"
+		"rjmp .+0"		"\n\t"
+		"rjmp .+0"		"\n\t"
+		"nop"			"\n\t"
+		"in  %A[q], %[al]"	"\n\t"
+		"in  %C[q], %[ah]"	"\n\t"
+		"in  %A[r], %[dy]"	"\n\t"
+		: [q] "=&r" (q), [r] "=&r" (r)
+		: [n] "r" (n), [d] "r" (d), [op] "r" ((uint8_t)UDSC_OP_DIVMOD),
+		  [dy] "I" (_SFR_IO_ADDR(DSDY)), [ir] "I" (_SFR_IO_ADDR(DSIR)),
+		  [al] "I" (_SFR_IO_ADDR(DSAL)), [ah] "I" (_SFR_IO_ADDR(DSAH))
+	);
+	SREG = oldSREG;
+
+	if (rem)
+		*rem = r;
+	return q;
+}
+
+static inline uint32_t udscDiv32(uint32_t n, uint16_t d)
+{
+	return udscDivMod32(n, d, 0);
+}
+
+#endif // __LGT8FX8P__
+
+#endif // __UDSC_H__
@@ -21,7 +21,107 @@
 */
 
 #include "wiring_private.h"
+#include <avr/sleep.h>
 
+#if LGT_TIMER3_MILLIS && defined(__LGT8FX8P__)
+#define TIMEKEEPING_TIMER3
+#endif
+
+#if defined(TIMEKEEPING_TIMER3)
+// Timer3 runs free over its whole 16 bit, at clk/8 from 16MHz up and at
+// clk/1 below. The overflow interrupt only carries the count and a coarse
+// millisecond sum, millis() and micros() add TCNT3 when they are called.
+#if F_CPU >= 16000000L
+#define TIMER3_PRESCALE_BITS	_BV(CS31)
+#define TIMER3_TICKS_PER_US	(F_CPU / 8000000L)
+#else
+#define TIMER3_PRESCALE_BITS	_BV(CS30)
+#define TIMER3_TICKS_PER_US	(F_CPU / 1000000L)
+#endif
+
+#if TIMER3_TICKS_PER_US == 2
+#define TIMER3_US_SHIFT	1
+#elif TIMER3_TICKS_PER_US == 4
+#define TIMER3_US_SHIFT	2
+#elif TIMER3_TICKS_PER_US == 8
+#define TIMER3_US_SHIFT	3
+#else
+#error Timer3 timekeeping needs a 2, 4, 8, 16 or 32 MHz clock
+#endif
+
+#define MICROSECONDS_PER_TIMER3_OVERFLOW (65536UL >> TIMER3_US_SHIFT)
+#define MILLIS_INC (MICROSECONDS_PER_TIMER3_OVERFLOW / 1000)
+#define FRACT_INC (MICROSECONDS_PER_TIMER3_OVERFLOW % 1000)
+
+volatile unsigned long timer3_overflow_count = 0;
+volatile unsigned long timer3_millis = 0;
+static unsigned int timer3_fract = 0;
+
+ISR(TIMER3_vect)
+{
+	PROFILE_CORE(PROFILE_ISR_MILLIS);
+	unsigned long m = timer3_millis;
+	unsigned int f = timer3_fract;
+
+	// shared vector, the flags are not cleared by hardware; compare B
+	// only wakes idleSleep() up
+	if (TIFR3 & _BV(OCF3B)) {
+		TIFR3 = _BV(OCF3B);
+		TIMSK3 &= ~_BV(OCIE3B);
+	}
+	if (!(TIFR3 & _BV(TOV3)))
+		return;
+	TIFR3 = _BV(TOV3);
+
+	m += MILLIS_INC;
+	f += FRACT_INC;
+	if (f >= 1000) {
+		f -= 1000;
+		m += 1;
+	}
+
+	timer3_fract = f;
+	timer3_millis = m;
+	timer3_overflow_count++;
+}
+
+unsigned long millis()
+{
+	unsigned long m;
+	unsigned int f, t;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	m = timer3_millis;
+	f = timer3_fract;
+	t = TCNT3;
+
+	// an overflow the interrupt has not seen yet
+	if ((TIFR3 & _BV(TOV3)) && (t < 0x8000)) {
+		m += MILLIS_INC;
+		f += FRACT_INC;
+	}
+	SREG = oldSREG;
+
+	// below 1000 + FRACT_INC + 32768, fits the 16 bit divide
+	return m + (f + (t >> TIMER3_US_SHIFT)) / 1000;
+}
+
+unsigned long micros() {
+	unsigned long m;
+	unsigned int t;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	m = timer3_overflow_count;
+	t = TCNT3;
+	if ((TIFR3 & _BV(TOV3)) && (t < 0x8000))
+		m++;
+	SREG = oldSREG;
+
+	return (m << (16 - TIMER3_US_SHIFT)) + (t >> TIMER3_US_SHIFT);
+}
+#else
 // the prescaler is set so that timer0 ticks every 64 clock cycles, and the
 // the overflow handler is called every 256 ticks.
 #define MICROSECONDS_PER_TIMER0_OVERFLOW (clockCyclesToMicroseconds(64 * 256))
@@ -45,6 +145,7 @@ ISR(TIM0_OVF_vect)
 ISR(TIMER0_OVF_vect)
 #endif
 {
+	PROFILE_CORE(PROFILE_ISR_MILLIS);
 	// copy these to local variables so they can be stored in registers
 	// (volatile variables must be read from memory on every access)
 	unsigned long m = timer0_millis;
@@ -99,9 +200,86 @@ unsigned long micros() {
 #endif
 
 	SREG = oldSREG;
-	
+
+#if LGT_UDSC && defined(__LGT8FX8P__)
+	if (!UDSC_IS_POW2(64 / clockCyclesPerMicrosecond()))
+		return udscMul32x16((m << 8) + t, 64 / clockCyclesPerMicrosecond());
+#endif
 	return ((m << 8) + t) * (64 / clockCyclesPerMicrosecond());
 }
+#endif
+
+// idleSleep() wakes up this much ahead of the deadline and leaves the rest
+// to the caller's polling, so the end of a wait does not move
+#define IDLE_MARGIN_US	16
+
+static uint8_t delay_idle = LGT_IDLE_DELAY;
+static volatile uint32_t idle_us;
+
+void delayIdle(uint8_t enable)
+{
+	delay_idle = enable;
+}
+
+// time spent in idle sleep since the last call, in microseconds
+uint32_t idleTime(void)
+{
+	uint32_t t;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	t = idle_us;
+	idle_us = 0;
+	SREG = oldSREG;
+
+	return t;
+}
+
+// IDLE sleep until the next interrupt, only when that comes before us
+// has passed: the timekeeping interrupt bounds the sleep, with Timer3
+// compare B armed for it, so the wake-up is never late. Timer0 overflows
+// every 1024us at 16MHz, so there it sleeps up to the next overflow when
+// that is due in time and leaves the rest to the caller to spin. With
+// interrupts off nothing would wake it, so it returns at once
+void idleSleep(uint32_t us)
+{
+	uint32_t start;
+	uint8_t oldSREG = SREG;
+
+	if (!(oldSREG & _BV(SREG_I)) || us <= IDLE_MARGIN_US)
+		return;
+	us -= IDLE_MARGIN_US;
+
+#if defined(TIMEKEEPING_TIMER3)
+	if (us > (0xff00UL >> TIMER3_US_SHIFT))
+		us = 0xff00UL >> TIMER3_US_SHIFT;
+	cli();
+	OCR3B = TCNT3 + (uint16_t)(us << TIMER3_US_SHIFT);
+	TIFR3 = _BV(OCF3B);
+	TIMSK3 |= _BV(OCIE3B);
+#else
+	// in clocks, Timer0 ticks at clk/64 and the current tick is counted
+	// whole so the overflow is never later than this; a whole Timer0
+	// period is 16384 clocks
+	if (us > 16384)
+		us = 16384;
+	cli();
+	if ((uint32_t)(256 - TCNT0) * 64 >= us * clockCyclesPerMicrosecond()) {
+		SREG = oldSREG;
+		return;
+	}
+#endif
+
+	start = micros();
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	sleep_enable();
+	// sei and sleep back to back, an interrupt in between still wakes
+	sei();
+	sleep_cpu();
+	sleep_disable();
+	idle_us += micros() - start;
+	SREG = oldSREG;
+}
 
 void delay(unsigned long ms)
 {
@@ -113,7 +291,88 @@ void delay(unsigned long ms)
 			ms--;
 			start += 1000;
 		}
+		// sleep out the current millisecond at most, yield() still runs
+		// once per millisecond
+		if (delay_idle && ms > 0) {
+			uint32_t elapsed = micros() - start;
+			if (elapsed < 1000)
+				idleSleep(1000 - elapsed);
+		}
+	}
+}
+
+#if defined(TCKCSR)
+// the doubler runs from the oscillator ahead of the system clock divider
+#if defined(F_OSC)
+#define F_TIMER_FAST	(2 * F_OSC)
+#else
+#define F_TIMER_FAST	64000000UL
+#endif
+
+void timerFastClock(uint8_t timers)
+{
+	uint8_t oldSREG = SREG;
+	uint8_t changed;
+
+	timers &= TIMER_FAST_CLOCK1 | TIMER_FAST_CLOCK3;
+#if defined(TIMEKEEPING_TIMER3)
+	// millis() counts Timer3 ticks at the system clock
+	timers &= ~TIMER_FAST_CLOCK3;
+#endif
+
+	cli();
+	// cycles() and the Timer1 capture count Timer1 at the system clock,
+	// see cyclesBegin()
+	if ((TIMSK1 & _BV(TOIE1)) && (TCCR1B & 0x07) == _BV(CS10))
+		timers &= ~TIMER_FAST_CLOCK1;
+	// DDS and tone() clock their samples or edges from compare A and the
+	// Timer3 capture counts timer clocks, a timer running one of them
+	// keeps the clock it started on
+	if (TIMSK1 & _BV(OCIE1A))
+		timers = (timers & ~TIMER_FAST_CLOCK1) | (TCKCSR & TIMER_FAST_CLOCK1);
+#if defined(TIMSK3)
+	if (TIMSK3 & (_BV(OCIE3A) | _BV(ICIE3)))
+		timers = (timers & ~TIMER_FAST_CLOCK3) | (TCKCSR & TIMER_FAST_CLOCK3);
+#endif
+
+	changed = (TCKCSR ^ timers) & (TIMER_FAST_CLOCK1 | TIMER_FAST_CLOCK3);
+	if (timers) {
+		// the doubler has to be up before a timer is switched over
+		if (bit_is_clear(TCKCSR, F2XEN)) {
+			TCKCSR = _BV(F2XEN);
+			delayMicroseconds(20);
+		}
+		TCKCSR = _BV(F2XEN) | timers;
+	} else {
+		TCKCSR = _BV(F2XEN);
+		TCKCSR = 0;
 	}
+
+	// running pwm keeps its frequency
+	if (changed & TIMER_FAST_CLOCK1)
+		__pwmClock(1, (timers & TIMER_FAST_CLOCK1) ? F_CPU : F_TIMER_FAST,
+			(timers & TIMER_FAST_CLOCK1) ? F_TIMER_FAST : F_CPU);
+	if (changed & TIMER_FAST_CLOCK3)
+		__pwmClock(3, (timers & TIMER_FAST_CLOCK3) ? F_CPU : F_TIMER_FAST,
+			(timers & TIMER_FAST_CLOCK3) ? F_TIMER_FAST : F_CPU);
+	SREG = oldSREG;
+}
+#endif
+
+// clock feeding Timer1/Timer3 ahead of their prescaler
+uint32_t timerClock(uint8_t timer)
+{
+#if defined(TCKCSR)
+	uint8_t mask = 0;
+
+	if (timer == 1)
+		mask = TIMER_FAST_CLOCK1;
+	else if (timer == 3)
+		mask = TIMER_FAST_CLOCK3;
+	if (TCKCSR & mask)
+		return F_TIMER_FAST;
+#endif
+	return F_CPU;
 }
 
 void init()
@@ -150,6 +409,13 @@ void init()
 	#error Timer 0 prescale factor 64 not set correctly
 #endif
 
+#if defined(TIMEKEEPING_TIMER3)
+	// timekeeping from the Timer3 overflow, Timer0 only does pwm
+	TCCR3A = 0;
+	TCCR3B = TIMER3_PRESCALE_BITS;
+	TIFR3 = _BV(TOV3);
+	TIMSK3 = _BV(TOIE3);
+#else
 	// enable timer 0 overflow interrupt
 #if defined(TIMSK) && defined(TOIE0)
 	sbi(TIMSK, TOIE0);
@@ -157,6 +423,7 @@ void init()
 	sbi(TIMSK0, TOIE0);
 #else
 	#error	Timer 0 overflow interrupt not set correctly
+#endif
 #endif
 
 	// timers 1 and 2 are used for phase-correct hardware pwm
@@ -201,7 +468,7 @@ void init()
 	// Timer 2 not finished (may not be present on this CPU)
 #endif
 
-#if defined(TCCR3B) && defined(CS31) && defined(WGM30)
+#if defined(TCCR3B) && defined(CS31) && defined(WGM30) && !defined(TIMEKEEPING_TIMER3)
 	sbi(TCCR3B, CS31);		// set timer 3 prescale factor to 64
 	sbi(TCCR3B, CS30);
 	sbi(TCCR3A, WGM30);		// put timer 3 in 8-bit phase correct pwm mode
@@ -249,6 +516,11 @@ void init()
 	#endif	
 	// enable a2d conversions
 	sbi(ADCSRA, ADEN);
+
+	#if defined(__LGT8FX8P__) && LGT_ADC_OFR
+	// program the hardware offset compensation for each reference
+	adcOffsetInit();
+	#endif
 #endif
 
 	// the bootloader connects pins 0 and 1 to the USART; disconnect them
@@ -259,4 +531,19 @@ void init()
 #elif defined(UCSR0B)
 	UCSR0B = 0;
 #endif
+
+#if LGT_PROFILE
+	// Timer1 becomes the cycle counter the profiler reads
+	cyclesBegin();
+#endif
+
+#if LGT_TIMER_F2X && defined(TCKCSR)
+	// pwm timers from the doubled oscillator, Timer0 keeps millis()
+	timerFastClock(TIMER_FAST_CLOCK1 | TIMER_FAST_CLOCK3);
+#endif
+
+#if LGT_UDSC && defined(__LGT8FX8P__)
+	// core arithmetic (print, map, micros, pulseIn) runs on the uDSC
+	udscBegin();
+#endif
 }
@@ -28,8 +28,29 @@
 uint8_t analog_resbit = 2;
 uint8_t analog_resdir = 1;
 uint8_t analog_reference = DEFAULT;
+#if defined(__LGT8F__)
+uint8_t analog_osbits = 4;
+#endif
+
+#if defined(__LGT8FX8P__) && LGT_ADC_OFR
+// hardware offset compensation (OFR0, OFR1) for each reference,
+// measured once the first time the reference is selected
+static int8_t adc_ofr[5][2];
+static uint8_t adc_ofr_valid;
+
+static void adcApplyOffset(void);
+#endif
 
 #if defined(__LGT8F__)
+// Above 12 bit up to this many bits are gained by oversampling, 4^bits
+// conversions per analogRead(); any remaining bits are shifted in as
+// before. Lower it to bound the time an analogRead() takes.
+void analogReadOversampling(uint8_t bits)
+{
+	if(bits > 4) bits = 4;
+	analog_osbits = bits;
+}
+
 void analogReadResolution(uint8_t res)
 {
 	if(res > 16) res = 16;
@@ -85,6 +106,10 @@ void analogReference(uint8_t mode)
 
 	ADMUX = (analog_reference << 6);
 #endif
+
+#if defined(__LGT8FX8P__) && LGT_ADC_OFR
+	adcApplyOffset();
+#endif
 }
 
 static uint16_t adcRead(void)
@@ -103,12 +128,138 @@ static uint16_t adcRead(void)
 	return ADC;
 }
 
-static int __analogRead(uint8_t pin)
+#if defined(__LGT8FX8P__) && LGT_ADC_OFR
+// Offset of the ADC comparator in LSB at one of the internal VCC
+// divider taps, half the difference of a conversion with swapped
+// comparator inputs (SPN). Returns -128 if the tap is out of range
+// for the current reference.
+static int8_t adcMeasureOffset(uint8_t pin)
+{
+	uint16_t nVal = 0, pVal = 0;
+	int16_t ofs;
+	uint8_t i;
+
+	adcSelect(pin);
+
+	sbi(ADCSRC, SPN);
+	adcRead();
+	for (i = 0; i < 8; i++)
+		nVal += adcRead();
+	cbi(ADCSRC, SPN);
+	adcRead();
+	for (i = 0; i < 8; i++)
+		pVal += adcRead();
+
+	// average of 8, a clipped or empty reading says nothing about the offset
+	nVal >>= 3;
+	pVal >>= 3;
+	if (nVal < 64 || pVal < 64 || nVal > 4031 || pVal > 4031)
+		return -128;
+
+	ofs = ((int16_t)nVal - (int16_t)pVal) >> 1;
+	if (ofs > 127) ofs = 127;
+	if (ofs < -127) ofs = -127;
+	return ofs;
+}
+
+static void adcCalibrateOffset(void)
+{
+	int8_t ofr0, ofr1;
+	uint8_t admux = ADMUX;
+
+	cbi(ADCSRC, OFEN);
+
+	// let a freshly selected internal reference settle
+	delayMicroseconds(200);
+
+	// databook flow: OFR0 from the 4/5 VCC tap, OFR1 from the 1/5 VCC tap.
+	// With a low reference only one of them is in range, use it for both.
+	ofr0 = adcMeasureOffset(V5D4);
+	ofr1 = adcMeasureOffset(V5D1);
+	if (ofr0 == -128) ofr0 = (ofr1 == -128) ? 0 : ofr1;
+	if (ofr1 == -128) ofr1 = ofr0;
+
+	ADCSRD &= 0xf0;
+	ADMUX = admux;
+
+	adc_ofr[analog_reference][0] = ofr0;
+	adc_ofr[analog_reference][1] = ofr1;
+	adc_ofr_valid |= _BV(analog_reference);
+}
+
+static void adcApplyOffset(void)
+{
+	if (analog_reference > INTERNAL4V096 || bit_is_clear(ADCSRA, ADEN))
+		return;
+
+	if (!(adc_ofr_valid & _BV(analog_reference)))
+		adcCalibrateOffset();
+
+	OFR0 = adc_ofr[analog_reference][0];
+	OFR1 = adc_ofr[analog_reference][1];
+	sbi(ADCSRC, OFEN);
+}
+
+// calibrate the internal references and AVCC up front, the EXTERNAL
+// reference is measured when it is first selected since AREF may not
+// be driven yet
+void adcOffsetInit(void)
+{
+	analogReference(INTERNAL1V024);
+	analogReference(INTERNAL2V048);
+	analogReference(INTERNAL4V096);
+	analogReference(DEFAULT);
+}
+#endif
+
+#if defined(ADCSRA) && defined(ADATE)
+// Flag register of an auto trigger source that has to be cleared from the
+// ADC interrupt, so the next event gives a new rising edge. Comparator and
+// INT0 flags belong to the sketch, and timer flags are left alone when their
+// interrupt is used, as is Timer0 overflow while millis() runs on it.
+volatile uint8_t *adcTriggerFlag(uint8_t trigger, uint8_t *mask)
+{
+	switch (trigger) {
+	case ADC_TRIGGER_TIMER0_COMPA:
+		if (bit_is_clear(TIMSK0, OCIE0A)) {
+			*mask = _BV(OCF0A);
+			return &TIFR0;
+		}
+		break;
+	case ADC_TRIGGER_TIMER0_OVF:
+		if (bit_is_clear(TIMSK0, TOIE0)) {
+			*mask = _BV(TOV0);
+			return &TIFR0;
+		}
+		break;
+	case ADC_TRIGGER_TIMER1_COMPB:
+		if (bit_is_clear(TIMSK1, OCIE1B)) {
+			*mask = _BV(OCF1B);
+			return &TIFR1;
+		}
+		break;
+	case ADC_TRIGGER_TIMER1_OVF:
+		if (bit_is_clear(TIMSK1, TOIE1)) {
+			*mask = _BV(TOV1);
+			return &TIFR1;
+		}
+		break;
+	case ADC_TRIGGER_TIMER1_CAPT:
+		if (bit_is_clear(TIMSK1, ICIE1)) {
+			*mask = _BV(ICF1);
+			return &TIFR1;
+		}
+		break;
+	}
+
+	return 0;
+}
+#endif
+
+// route pin to the ADC input, returns 0 if the pin has no ADC channel
+uint8_t adcSelect(uint8_t pin)
 {
-	uint16_t pVal;
 #if defined(__LGT8FX8P__)
-	uint16_t nVal;
-	
 	// enable/disable internal 1/5VCC channel
 	ADCSRD &= 0xf0;
 	if(pin == V5D1 || pin == V5D4 || pin == VCCM) { 
@@ -155,11 +306,25 @@ static int __analogRead(uint8_t pin)
 #endif
 #endif
 
+	return 1;
+}
+
+static int __analogRead(uint8_t pin)
+{
+	uint16_t pVal;
+#if defined(__LGT8FX8P__) && !LGT_ADC_OFR
+	uint16_t nVal;
+#endif
+
+	if (!adcSelect(pin)) return 0;
+
 	// without a delay, we seem to read from the wrong channel
 	//delay(1);
 
 #if defined(ADCSRA) && defined(ADCL)
-	#if defined(__LGT8FX8P__)
+	// with LGT_ADC_OFR the offset is removed by OFR0/OFR1 in hardware,
+	// otherwise average a conversion with swapped comparator inputs
+	#if defined(__LGT8FX8P__) && !LGT_ADC_OFR
 	sbi(ADCSRC, SPN);
 	nVal = adcRead();
 	cbi(ADCSRC, SPN);
@@ -167,7 +332,7 @@ static int __analogRead(uint8_t pin)
 	
 	pVal = adcRead();
 
-	#if defined(__LGT8FX8P__)
+	#if defined(__LGT8FX8P__) && !LGT_ADC_OFR
 	pVal = (pVal + nVal) >> 1;
 	#endif
 #else
@@ -175,19 +340,39 @@ static int __analogRead(uint8_t pin)
 	pVal = 0;
 #endif
 
-	// gain-error correction
-#if defined(__LGT8FX8E__)
-//	pVal -= (pVal >> 5);
-	pVal -= 0;
-#elif defined(__LGT8FX8P__)
-	pVal -= (pVal >> 7);
-#endif
 	// standard device from atmel
-	return pVal;
+	return adcGainCorrect(pVal);
+}
+
+#if defined(__LGT8F__) && defined(ADCSRA) && defined(ADCL)
+// Oversample and decimate: the sum of 4^bits conversions shifted right by
+// bits gives a (12 + bits) bit result, the ADC noise acts as dither.
+static uint16_t __analogOversample(uint8_t pin, uint8_t bits)
+{
+	uint32_t sum = 0;
+	uint16_t n = 1 << (bits << 1);
+
+	if (!adcSelect(pin)) return 0;
+
+	do {
+	#if defined(__LGT8FX8P__) && !LGT_ADC_OFR
+		// alternate the comparator inputs, the offset cancels in the sum
+		ADCSRC ^= _BV(SPN);
+	#endif
+		sum += adcRead();
+	} while (--n);
+
+	#if defined(__LGT8FX8P__) && !LGT_ADC_OFR
+	cbi(ADCSRC, SPN);
+	#endif
+
+	return adcGainCorrect(sum >> bits);
 }
+#endif
 
 int analogRead(uint8_t pin)
 {
+	PROFILE_CORE(PROFILE_ANALOG_READ);
 #if defined(__LGT8F__)
 	if(analog_resbit == 0)
 		return __analogRead(pin);
@@ -195,6 +380,12 @@ int analogRead(uint8_t pin)
 	if(analog_resdir == 1) {
 		return __analogRead(pin) >> analog_resbit;
 	} else {
+	#if defined(ADCSRA) && defined(ADCL)
+		uint8_t bits = analog_resbit;
+		if(bits > analog_osbits) bits = analog_osbits;
+		if(bits > 0)
+			return __analogOversample(pin, bits) << (analog_resbit - bits);
+	#endif
 		return __analogRead(pin) << analog_resbit;
 	}
 #else
@@ -208,6 +399,17 @@ int analogRead(uint8_t pin)
 // pins_*.c file.  For the rest of the pins, we default
 // to digital output.
 
+#if defined(TCKCSR)
+// timerFastClock() may have moved the 8 bit phase correct mode of
+// Timer1/Timer3 to 9 or 10 bit (WGMn1:0 = 2, 3) to keep its frequency;
+// the fast pwm of analogWriteFrequency() takes raw values
+#define PWM_DUTY(tccra, tccrb, val) \
+	((!((tccrb) & (_BV(WGM13) | _BV(WGM12))) && ((tccra) & 3) > 1) ? \
+		(uint16_t)(val) << (((tccra) & 3) - 1) : (val))
+#else
+#define PWM_DUTY(tccra, tccrb, val)	(val)
+#endif
+
 void analogWrite(uint8_t pin, int val)
 {
 	// We need to make sure the PWM output is enabled for those pins
@@ -261,7 +463,7 @@ void analogWrite(uint8_t pin, int val)
 			case TIMER1A:
 				// connect pwm to pin on timer 1, channel A
 				sbi(TCCR1A, COM1A1);
-				OCR1A = val; // set pwm duty
+				OCR1A = PWM_DUTY(TCCR1A, TCCR1B, val); // set pwm duty
 				break;
 			#endif
 
@@ -269,7 +471,7 @@ void analogWrite(uint8_t pin, int val)
 			case TIMER1B:
 				// connect pwm to pin on timer 1, channel B
 				sbi(TCCR1A, COM1B1);
-				OCR1B = val; // set pwm duty
+				OCR1B = PWM_DUTY(TCCR1A, TCCR1B, val); // set pwm duty
 				break;
 			#endif
 
@@ -305,7 +507,9 @@ void analogWrite(uint8_t pin, int val)
 				break;
 			#endif
 
-			#if defined(TCCR3A) && defined(COM3A1)
+			// Timer3 runs in normal mode for Tickless timekeeping,
+			// its pins then only go fully on or off
+			#if defined(TCCR3A) && defined(COM3A1) && !LGT_TIMER3_MILLIS
 			case TIMER3A:
 				// connect pwm to pin on timer 3, channel A
 				// and switch pin data direction of PORTD to input and PORTE to output
@@ -314,11 +518,11 @@ void analogWrite(uint8_t pin, int val)
 				cbi(DDRD,DDD1);
 				#endif
 				sbi(DDRF,DDF1);
-				OCR3A = val; // set pwm duty
+				OCR3A = PWM_DUTY(TCCR3A, TCCR3B, val); // set pwm duty
 				break;
 			#endif
 
-			#if defined(TCCR3A) && defined(COM3B1)
+			#if defined(TCCR3A) && defined(COM3B1) && !LGT_TIMER3_MILLIS
 			case TIMER3B:
 				// connect pwm to pin on timer 3, channel B
 				// and switch pin data direction of PORTD to input and PORTE to output
@@ -327,16 +531,16 @@ void analogWrite(uint8_t pin, int val)
 				cbi(DDRD,DDD2);
 				#endif
 				sbi(DDRF,DDF2);
-				OCR3B = val; // set pwm duty
+				OCR3B = PWM_DUTY(TCCR3A, TCCR3B, val); // set pwm duty
 				break;
 			#endif
 
-			#if defined(TCCR3A) && defined(COM3C1)
+			#if defined(TCCR3A) && defined(COM3C1) && !LGT_TIMER3_MILLIS
 			case TIMER3C:
 				// connect pwm to pin on timer 3, channel C
 				sbi(TCCR3A, COM3C1);
 				sbi(DDRF,DDF3);
-				OCR3C = val; // set pwm duty
+				OCR3C = PWM_DUTY(TCCR3A, TCCR3B, val); // set pwm duty
 				break;
 			#endif
 
@@ -0,0 +1,103 @@
+/*
+  wiring_analog_monitor.c - ADC auto channel monitor
+  Part of the LGT8Fx core
+
+  With AMEN set the LGT8FX8P converts the selected channel on its own and
+  compares every result against ADT0 (underflow) and ADT1 (overflow).
+  Only when AMFC consecutive results are outside that window ADIF is set
+  and the monitor stops, so the CPU is interrupted once per excursion and
+  can stay in idle sleep (LowPower.idle() with ADC_ON) until then.
+
+  This owns the ADC interrupt like analogStream and analogScan, only one
+  of them can be used in a sketch.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8FX8P__)
+
+static void (*monitor_func)(uint8_t event, uint16_t value);
+static volatile uint8_t monitor_event;
+
+// thresholds are given like analogRead() results at 12 bit, undo the gain
+// correction so the hardware compares against the same scale
+static uint16_t monitorRaw(uint16_t val)
+{
+	val += val >> 7;
+	return (val > 4095) ? 4095 : val;
+}
+
+uint8_t analogMonitor(uint8_t pin, uint16_t low, uint16_t high, uint8_t filter, void (*callback)(uint8_t event, uint16_t value))
+{
+	analogMonitorEnd();
+
+	if (low > high || !adcSelect(pin))
+		return 0;
+
+	if (filter < 1) filter = 1;
+	if (filter > 15) filter = 15;
+
+	monitor_func = callback;
+	monitor_event = 0;
+
+	ADT0 = monitorRaw(low);
+	ADT1 = monitorRaw(high);
+	ADMSC = filter;
+
+	ADCSRA |= _BV(ADIF) | _BV(ADIE);
+	sbi(ADCSRC, AMEN);
+
+	return 1;
+}
+
+void analogMonitorResume(void)
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	monitor_event = 0;
+	cbi(ADCSRC, AMEN);
+	ADCSRA |= _BV(ADIF);
+	sbi(ADCSRC, AMEN);
+	SREG = oldSREG;
+}
+
+void analogMonitorEnd(void)
+{
+	cbi(ADCSRC, AMEN);
+	ADCSRA &= ~_BV(ADIE);
+	ADCSRA |= _BV(ADIF);
+	ADCSRD &= 0xf0;
+	ADMSC = _BV(AMFC0);
+}
+
+uint8_t analogMonitorEvent(void)
+{
+	uint8_t event;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	event = monitor_event;
+	monitor_event = 0;
+	SREG = oldSREG;
+
+	return event;
+}
+
+ISR(ADC_vect)
+{
+	uint8_t event = bit_is_set(ADMSC, AMOF) ? ANALOG_MONITOR_HIGH : ANALOG_MONITOR_LOW;
+
+	// the monitor has stopped, it is restarted by analogMonitorResume()
+	monitor_event = event;
+	if (monitor_func)
+		monitor_func(event, adcGainCorrect(ADC));
+}
+
+#endif
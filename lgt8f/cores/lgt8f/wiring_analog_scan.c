@@ -0,0 +1,177 @@
+/*
+  wiring_analog_scan.c - multi-channel ADC scan sequencer
+  Part of the LGT8Fx core
+
+  Each trigger event converts the whole pin list back to back. The ADMUX
+  and ADCSRD values of every pin are worked out once in analogScanBegin(),
+  so the ADC interrupt only has to load them and restart the converter.
+  Results go to the back half of a double buffered table, which becomes
+  the front half when the list is done and the sequence counter moves on.
+  Readers copy the front half and only retry if a whole scan finished in
+  between, the interrupt never waits for them.
+
+  This owns the ADC interrupt like analogStream and analogMonitor, only
+  one of them can be used in a sketch.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8F__) && defined(ADCSRA) && defined(ADATE)
+
+static uint8_t scan_admux[ANALOG_SCAN_MAX];
+#if defined(__LGT8FX8P__)
+static uint8_t scan_adcsrd[ANALOG_SCAN_MAX];
+#endif
+static uint16_t scan_table[2][ANALOG_SCAN_MAX];
+static uint8_t scan_count;
+static uint8_t scan_free_running;
+static volatile uint8_t scan_index;
+static volatile uint8_t scan_front;
+static volatile uint16_t scan_seq;
+
+static volatile uint8_t *scan_tifr;
+static uint8_t scan_tmask;
+
+static inline void scanSelect(uint8_t i)
+{
+#if defined(__LGT8FX8P__)
+	ADCSRD = (ADCSRD & 0xf0) | scan_adcsrd[i];
+#endif
+	ADMUX = scan_admux[i];
+}
+
+uint8_t analogScanBegin(const uint8_t *pins, uint8_t count, uint8_t trigger)
+{
+	uint8_t i;
+
+	analogScanEnd();
+
+	if (count == 0 || count > ANALOG_SCAN_MAX || trigger > ADC_TRIGGER_TIMER1_CAPT)
+		return 0;
+
+	for (i = 0; i < count; i++) {
+		if (!adcSelect(pins[i]))
+			return 0;
+		scan_admux[i] = ADMUX;
+#if defined(__LGT8FX8P__)
+		scan_adcsrd[i] = ADCSRD & 0x0f;
+#endif
+	}
+
+	scan_count = count;
+	scan_index = 0;
+	scan_front = 0;
+	scan_seq = 0;
+	memset(scan_table, 0, sizeof(scan_table));
+
+	scan_tifr = adcTriggerFlag(trigger, &scan_tmask);
+	scan_free_running = (trigger == ADC_FREE_RUNNING);
+
+	scanSelect(0);
+	ADCSRA |= _BV(ADIF);
+	if (scan_free_running) {
+		// back to back scans, restarted from the interrupt
+		ADCSRA |= _BV(ADIE);
+		sbi(ADCSRA, ADSC);
+	} else {
+		// the trigger starts the first pin, the interrupt the rest
+		ADCSRB = (ADCSRB & 0xf8) | trigger;
+		ADCSRA |= _BV(ADATE) | _BV(ADIE);
+	}
+
+	return 1;
+}
+
+void analogScanEnd(void)
+{
+	ADCSRA &= ~(_BV(ADATE) | _BV(ADIE));
+	ADCSRB &= 0xf8;
+
+	while (bit_is_set(ADCSRA, ADSC));
+	ADCSRA |= _BV(ADIF);
+#if defined(__LGT8FX8P__)
+	ADCSRD &= 0xf0;
+#endif
+}
+
+uint16_t analogScanSequence(void)
+{
+	uint16_t seq;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	seq = scan_seq;
+	SREG = oldSREG;
+
+	return seq;
+}
+
+uint16_t analogScanSnapshot(uint16_t *values)
+{
+	uint16_t seq;
+	const uint16_t *src;
+	uint8_t i, oldSREG;
+
+	for (;;) {
+		oldSREG = SREG;
+		cli();
+		seq = scan_seq;
+		src = scan_table[scan_front];
+		SREG = oldSREG;
+
+		for (i = 0; i < scan_count; i++)
+			values[i] = src[i];
+
+		// the interrupt only writes the back half, the front half is
+		// intact unless a scan completed while it was being copied
+		if (seq == analogScanSequence())
+			return seq;
+	}
+}
+
+int analogScanRead(uint8_t index)
+{
+	int val;
+	uint8_t oldSREG = SREG;
+
+	if (index >= scan_count)
+		return -1;
+
+	cli();
+	val = scan_table[scan_front][index];
+	SREG = oldSREG;
+
+	return val;
+}
+
+ISR(ADC_vect)
+{
+	uint8_t i = scan_index;
+	uint8_t back = scan_front ^ 1;
+
+	scan_table[back][i] = adcGainCorrect(ADC);
+
+	if (++i == scan_count) {
+		scan_front = back;
+		scan_seq++;
+		i = 0;
+
+		if (scan_tifr)
+			*scan_tifr = scan_tmask;
+	}
+	scan_index = i;
+
+	// the next pin is converted right away, the first pin of a new scan
+	// waits for the trigger unless the scan is free running
+	scanSelect(i);
+	if (i != 0 || scan_free_running)
+		sbi(ADCSRA, ADSC);
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+  wiring_analog_stream.c - interrupt driven ADC sampling
+  Part of the LGT8Fx core
+
+  The ADC is started in auto trigger mode, either free running or from
+  one of the ADTS trigger sources, and every conversion is pushed into a
+  ring buffer from the ADC interrupt. The sketch only drains finished
+  samples, nothing in here waits for the converter.
+
+  This owns the ADC interrupt like analogScan and analogMonitor, only one
+  of them can be used in a sketch.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8F__) && defined(ADCSRA) && defined(ADATE)
+
+static uint16_t *stream_buf;
+static uint8_t stream_len;
+static volatile uint8_t stream_head;
+static volatile uint8_t stream_tail;
+static volatile uint16_t stream_overruns;
+
+// trigger flag to clear after each conversion, so the next edge can start one
+static volatile uint8_t *stream_tifr;
+static uint8_t stream_tmask;
+
+// optional per-sample hook, may rewrite the sample or drop it
+static uint16_t (*stream_hook)(uint16_t val);
+
+void analogStreamHook(uint16_t (*hook)(uint16_t val))
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	stream_hook = hook;
+	SREG = oldSREG;
+}
+
+uint8_t analogStreamBegin(uint8_t pin, uint16_t *buf, uint8_t len, uint8_t trigger)
+{
+	analogStreamEnd();
+
+	if (buf == 0 || len < 2 || trigger > ADC_TRIGGER_TIMER1_CAPT)
+		return 0;
+
+	stream_buf = buf;
+	stream_len = len;
+	stream_head = 0;
+	stream_tail = 0;
+	stream_overruns = 0;
+
+	stream_tifr = adcTriggerFlag(trigger, &stream_tmask);
+
+	if (!adcSelect(pin))
+		return 0;
+
+	// ADCSRB upper bits hold the comparator input selection
+	ADCSRB = (ADCSRB & 0xf8) | trigger;
+	ADCSRA |= _BV(ADIF);
+	ADCSRA |= _BV(ADATE) | _BV(ADIE);
+
+	// free running mode needs the first conversion started by hand
+	if (trigger == ADC_FREE_RUNNING)
+		sbi(ADCSRA, ADSC);
+
+	return 1;
+}
+
+void analogStreamEnd(void)
+{
+	ADCSRA &= ~(_BV(ADATE) | _BV(ADIE));
+	ADCSRB &= 0xf8;
+
+	// let a running conversion finish, so analogRead() starts clean
+	while (bit_is_set(ADCSRA, ADSC));
+	ADCSRA |= _BV(ADIF);
+}
+
+uint8_t analogStreamAvailable(void)
+{
+	uint8_t head = stream_head;
+	uint8_t tail = stream_tail;
+
+	if (head >= tail)
+		return head - tail;
+	return stream_len - tail + head;
+}
+
+int analogStreamRead(void)
+{
+	uint8_t tail = stream_tail;
+	uint16_t val;
+
+	if (tail == stream_head)
+		return -1;
+
+	val = stream_buf[tail];
+	if (++tail == stream_len)
+		tail = 0;
+	stream_tail = tail;
+
+	return val;
+}
+
+uint16_t analogStreamOverruns(void)
+{
+	uint16_t n;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	n = stream_overruns;
+	stream_overruns = 0;
+	SREG = oldSREG;
+
+	return n;
+}
+
+ISR(ADC_vect)
+{
+	uint16_t val = adcGainCorrect(ADC);
+	uint8_t head = stream_head;
+	uint8_t next = head + 1;
+
+	if (stream_tifr)
+		*stream_tifr = stream_tmask;
+
+	if (stream_hook) {
+		val = stream_hook(val);
+		if (val == ANALOG_STREAM_SKIP)
+			return;
+	}
+
+	if (next == stream_len)
+		next = 0;
+
+	// buffer full, the sample is dropped and counted
+	if (next == stream_tail) {
+		if (stream_overruns != 0xffff)
+			stream_overruns++;
+		return;
+	}
+
+	stream_buf[head] = val;
+	stream_head = next;
+}
+
+#endif
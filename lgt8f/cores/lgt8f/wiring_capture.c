@@ -0,0 +1,117 @@
+/*
+  wiring_capture.c - input capture ring buffers
+  Part of the LGT8Fx core
+
+  See capture.h. The timer setup and the capture interrupt live in one
+  file per timer, so only the timer passed to pulseCaptureBegin() links
+  its interrupt.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+
+__capture_t __capture[2];
+
+static __capture_t *captureState(uint8_t timer)
+{
+#if defined(__CAPTURE_TIMER3)
+	if (timer == CAPTURE_TIMER3)
+		return &__capture[1];
+#endif
+	if (timer == CAPTURE_TIMER1)
+		return &__capture[0];
+	return 0;
+}
+
+uint8_t __captureSetup(uint8_t timer, capture_edge_t *buf, uint8_t len)
+{
+	__capture_t *c = captureState(timer);
+
+	if (!c || buf == 0 || len < 2)
+		return 0;
+
+	pulseCaptureEnd(timer);
+
+	c->buf = buf;
+	c->len = len;
+	c->head = 0;
+	c->tail = 0;
+	c->overruns = 0;
+
+	return 1;
+}
+
+void pulseCaptureEnd(uint8_t timer)
+{
+	__capture_t *c = captureState(timer);
+
+	if (c && c->stop) {
+		c->stop();
+		c->stop = 0;
+	}
+}
+
+uint8_t pulseCaptureAvailable(uint8_t timer)
+{
+	__capture_t *c = captureState(timer);
+	uint8_t head, tail;
+
+	if (!c || !c->len)
+		return 0;
+
+	head = c->head;
+	tail = c->tail;
+	if (head >= tail)
+		return head - tail;
+	return c->len - tail + head;
+}
+
+uint8_t pulseCaptureRead(uint8_t timer, capture_edge_t *edge)
+{
+	__capture_t *c = captureState(timer);
+	uint8_t tail;
+
+	if (!c)
+		return 0;
+
+	tail = c->tail;
+	if (tail == c->head)
+		return 0;
+
+	*edge = c->buf[tail];
+	if (++tail == c->len)
+		tail = 0;
+	c->tail = tail;
+
+	return 1;
+}
+
+uint16_t pulseCaptureOverruns(uint8_t timer)
+{
+	__capture_t *c = captureState(timer);
+	uint16_t n;
+	uint8_t oldSREG = SREG;
+
+	if (!c)
+		return 0;
+
+	cli();
+	n = c->overruns;
+	c->overruns = 0;
+	SREG = oldSREG;
+
+	return n;
+}
+
+uint32_t pulseCaptureClock(uint8_t timer)
+{
+	return timerClock(timer);
+}
+
+#endif
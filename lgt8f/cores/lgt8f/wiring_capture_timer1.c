@@ -0,0 +1,75 @@
+/*
+  wiring_capture_timer1.c - input capture on ICP1
+  Part of the LGT8Fx core
+
+  Timer1 runs as the cycles() counter, normal mode at clk/1, and the
+  capture interrupt extends ICR1 with its overflow count, see capture.h.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+
+static void captureTimer1Stop(void)
+{
+	TIMSK1 &= ~_BV(ICIE1);
+	TCCR1B &= ~(_BV(ICNC1) | _BV(ICES1));
+}
+
+uint8_t __captureTimer1Start(uint8_t mode)
+{
+	__capture_t *c = &__capture[0];
+	uint8_t edge = mode & ~CAPTURE_NOISE_CANCEL;
+	uint8_t oldSREG;
+
+	if (edge != RISING && edge != FALLING && edge != CHANGE)
+		return 0;
+
+	// the cycles() counter may already run for the profiler
+	if (!(TIMSK1 & _BV(TOIE1)) || (TCCR1B & 0x07) != _BV(CS10))
+		cyclesBegin();
+
+	pinMode(8, INPUT);
+
+	oldSREG = SREG;
+	cli();
+	c->change = (edge == CHANGE);
+	TCCR1B = (TCCR1B & ~(_BV(ICNC1) | _BV(ICES1))) |
+		((mode & CAPTURE_NOISE_CANCEL) ? _BV(ICNC1) : 0) |
+		// CHANGE starts on the edge away from the current level
+		((edge == RISING || (edge == CHANGE && !(PINB & _BV(0)))) ? _BV(ICES1) : 0);
+	TIFR1 = _BV(ICF1);
+	c->stop = captureTimer1Stop;
+	TIMSK1 |= _BV(ICIE1);
+	SREG = oldSREG;
+
+	return 1;
+}
+
+ISR(TIMER1_CAPT_vect)
+{
+	__capture_t *c = &__capture[0];
+	uint16_t lo = ICR1;
+	uint16_t hi = __cycles_overflow;
+	uint8_t level = (TCCR1B & _BV(ICES1)) ? HIGH : LOW;
+
+	// an overflow the interrupt has not counted yet, ahead of the capture
+	if ((TIFR1 & _BV(TOV1)) && (lo < 0x8000))
+		hi++;
+
+	if (c->change) {
+		TCCR1B ^= _BV(ICES1);
+		// switching the edge may set the flag again
+		TIFR1 = _BV(ICF1);
+	}
+
+	__capturePush(c, ((uint32_t)hi << 16) | lo, level);
+}
+
+#endif
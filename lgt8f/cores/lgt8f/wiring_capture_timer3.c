@@ -0,0 +1,90 @@
+/*
+  wiring_capture_timer3.c - input capture on ICP3
+  Part of the LGT8Fx core
+
+  Timer3 counts in normal mode at clk/1, the shared Timer3 interrupt
+  counts its overflows and extends ICR3 with them, see capture.h. Not
+  built with Tickless timekeeping, which owns that interrupt.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8FX8P__) && defined(__CAPTURE_TIMER3)
+
+static volatile uint16_t capture3_overflow;
+
+static void captureTimer3Stop(void)
+{
+	TIMSK3 &= ~(_BV(ICIE3) | _BV(TOIE3));
+
+	// back to the 8-bit phase correct pwm set up by init()
+	TCCR3B = 0;
+	TCCR3A = _BV(WGM30);
+	TCNT3 = 0;
+	TCCR3B = _BV(CS31) | _BV(CS30);
+}
+
+uint8_t __captureTimer3Start(uint8_t mode)
+{
+	__capture_t *c = &__capture[1];
+	uint8_t edge = mode & ~CAPTURE_NOISE_CANCEL;
+	uint8_t oldSREG;
+
+	if (edge != RISING && edge != FALLING && edge != CHANGE)
+		return 0;
+
+	oldSREG = SREG;
+	cli();
+	TCCR3B = 0;
+	TCCR3A = 0;
+	TCNT3 = 0;
+	capture3_overflow = 0;
+	c->change = (edge == CHANGE);
+	TIFR3 = _BV(ICF3) | _BV(TOV3);
+	c->stop = captureTimer3Stop;
+	TIMSK3 |= _BV(ICIE3) | _BV(TOIE3);
+	// CHANGE starts on a rising edge, the first entry tells which it was
+	TCCR3B = ((mode & CAPTURE_NOISE_CANCEL) ? _BV(ICNC3) : 0) |
+		((edge != FALLING) ? _BV(ICES3) : 0) | _BV(CS30);
+	SREG = oldSREG;
+
+	return 1;
+}
+
+ISR(TIMER3_vect)
+{
+	__capture_t *c = &__capture[1];
+	uint8_t flags = TIFR3;
+	uint16_t lo, hi;
+	uint8_t level;
+
+	// shared vector, the flags are not cleared by hardware
+	if (flags & _BV(ICF3)) {
+		lo = ICR3;
+		hi = capture3_overflow;
+		level = (TCCR3B & _BV(ICES3)) ? HIGH : LOW;
+
+		// an overflow not counted yet, ahead of the capture
+		if ((flags & _BV(TOV3)) && (lo < 0x8000))
+			hi++;
+
+		if (c->change)
+			TCCR3B ^= _BV(ICES3);
+		TIFR3 = _BV(ICF3);
+
+		__capturePush(c, ((uint32_t)hi << 16) | lo, level);
+	}
+
+	if (flags & _BV(TOV3)) {
+		TIFR3 = _BV(TOV3);
+		capture3_overflow++;
+	}
+}
+
+#endif
@@ -0,0 +1,58 @@
+/*
+  wiring_cycles.c - free running cycle counter on Timer1
+  Part of the LGT8Fx core
+
+  Timer1 counts at clk/1 over its whole 16 bit range in normal mode, the
+  overflow interrupt extends it by another 16 bit, see cycles() in
+  profile.h. It stays on the system clock while it counts, whatever
+  timerFastClock() is asked for.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+
+volatile uint16_t __cycles_overflow;
+
+void cyclesBegin(void)
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+#if defined(TCKCSR)
+	// the count is in system clocks, so Timer1 leaves the fast clock
+	if (TCKCSR & TIMER_FAST_CLOCK1)
+		timerFastClock(TCKCSR & TIMER_FAST_CLOCK3);
+#endif
+	TCCR1B = 0;
+	TCCR1A = 0;
+	TCNT1 = 0;
+	__cycles_overflow = 0;
+	TIFR1 = _BV(TOV1);
+	TIMSK1 |= _BV(TOIE1);
+	TCCR1B = _BV(CS10);
+	SREG = oldSREG;
+}
+
+void cyclesEnd(void)
+{
+	TIMSK1 &= ~_BV(TOIE1);
+
+	// back to the 8-bit phase correct pwm set up by init()
+	TCCR1B = 0;
+	TCCR1A = _BV(WGM10);
+	TCNT1 = 0;
+#if F_CPU >= 8000000L
+	TCCR1B = _BV(CS11) | _BV(CS10);
+#else
+	TCCR1B = _BV(CS11);
+#endif
+}
+
+ISR(TIMER1_OVF_vect)
+{
+	__cycles_overflow++;
+}
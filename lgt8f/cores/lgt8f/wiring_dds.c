@@ -0,0 +1,232 @@
+/*
+  wiring_dds.c - direct digital synthesis on the internal DAC
+  Part of the LGT8Fx core
+
+  State and the main line side of the DDS engine, see dds.h. The timer
+  setup and the interrupt live in wiring_dds_timer1.c/wiring_dds_timer3.c
+  so a sketch only pulls in the vector of the timer it asked for.
+
+  All values the interrupt picks up are at most a pointer or a 32 bit
+  word, they are replaced with interrupts held off and take effect on the
+  next sample, the phase accumulator itself is never touched.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+
+// the interrupt needs this many cpu cycles at most, faster rates are clamped
+#define DDS_MIN_CYCLES	128
+
+const uint8_t ddsSine[256] PROGMEM = {
+	128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+	176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+	218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+	245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+	255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+	245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+	218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+	176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+	128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+	 79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+	 37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+	 10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,
+	  0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+	 10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+	 37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+	 79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+};
+
+volatile uint8_t *__dds_dal;
+const uint8_t * volatile __dds_table;
+uint32_t __dds_phase;
+volatile uint32_t __dds_step;
+uint8_t __dds_next;
+uint8_t * volatile __dds_buf;
+uint8_t __dds_len;
+volatile uint8_t __dds_head;
+volatile uint8_t __dds_tail;
+volatile uint16_t __dds_underruns;
+void (*__dds_stop)(void);
+
+static uint32_t dds_rate;
+
+uint8_t __ddsSetup(uint8_t pin)
+{
+	ddsEnd();
+
+	if (pin == DAC0) {
+		__dds_dal = &DAL0;
+#if defined(DAL1)
+	} else if (pin == DAC1) {
+		__dds_dal = &DAL1;
+#endif
+	} else {
+		return 0;
+	}
+
+	__dds_table = ddsSine;
+	__dds_phase = 0;
+	__dds_step = 0;
+	__dds_next = pgm_read_byte(ddsSine);
+	__dds_buf = 0;
+
+	pinMode(pin, ANALOG);
+
+	return 1;
+}
+
+// CTC top value and clock select for rate, the rate actually reached is
+// kept for ddsFrequency()
+uint16_t __ddsTop(uint32_t clock, uint32_t rate, uint8_t *cs)
+{
+	uint32_t cycles = rate ? clock / rate : 0;
+	uint32_t least = DDS_MIN_CYCLES * (clock / F_CPU);
+	uint8_t shift = 0;
+
+	if (cycles < least)
+		cycles = least;
+
+	// clk/1, clk/8, clk/64
+	*cs = 1;
+	while (cycles > 65536UL && *cs < 3) {
+		cycles >>= 3;
+		shift += 3;
+		(*cs)++;
+	}
+	if (cycles > 65536UL)
+		cycles = 65536UL;
+
+	dds_rate = (clock >> shift) / cycles;
+
+	return cycles - 1;
+}
+
+void ddsEnd(void)
+{
+	if (__dds_stop)
+		__dds_stop();
+	__dds_stop = 0;
+}
+
+uint32_t ddsSampleRate(void)
+{
+	return __dds_stop ? dds_rate : 0;
+}
+
+void ddsWavetable(const uint8_t *table)
+{
+	uint8_t oldSREG = SREG;
+
+	if (!table)
+		table = ddsSine;
+
+	cli();
+	__dds_table = table;
+	SREG = oldSREG;
+}
+
+void ddsTuningWord(uint32_t step)
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	__dds_step = step;
+	SREG = oldSREG;
+}
+
+// tuning word = hz * 2^32 / rate, worked out a byte at a time so the
+// remainder (below the rate) never overflows
+uint32_t ddsFrequency(uint32_t hz)
+{
+	uint32_t step = 0;
+	uint32_t rem;
+	uint8_t i;
+
+	if (dds_rate == 0)
+		return 0;
+
+	rem = hz % dds_rate;
+	for (i = 0; i < 4; i++) {
+		rem <<= 8;
+		step = (step << 8) | (rem / dds_rate);
+		rem %= dds_rate;
+	}
+	if (rem >= dds_rate - rem)
+		step++;
+
+	ddsTuningWord(step);
+
+	return step;
+}
+
+uint8_t ddsBuffer(uint8_t *buf, uint8_t len)
+{
+	uint8_t oldSREG = SREG;
+
+	if (buf && len < 2)
+		return 0;
+
+	cli();
+	__dds_len = len;
+	__dds_head = 0;
+	__dds_tail = 0;
+	__dds_underruns = 0;
+	__dds_buf = buf;
+	SREG = oldSREG;
+
+	return 1;
+}
+
+uint8_t ddsWrite(uint8_t val)
+{
+	uint8_t head = __dds_head;
+	uint8_t next = head + 1;
+
+	if (!__dds_buf)
+		return 0;
+
+	if (next == __dds_len)
+		next = 0;
+	if (next == __dds_tail)
+		return 0;
+
+	__dds_buf[head] = val;
+	__dds_head = next;
+
+	return 1;
+}
+
+uint8_t ddsAvailableForWrite(void)
+{
+	uint8_t head = __dds_head;
+	uint8_t tail = __dds_tail;
+
+	if (!__dds_buf)
+		return 0;
+
+	if (tail > head)
+		return tail - head - 1;
+	return __dds_len - head + tail - 1;
+}
+
+uint16_t ddsUnderruns(void)
+{
+	uint16_t n;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	n = __dds_underruns;
+	__dds_underruns = 0;
+	SREG = oldSREG;
+
+	return n;
+}
+
+#endif
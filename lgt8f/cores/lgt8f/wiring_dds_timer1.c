@@ -0,0 +1,57 @@
+/*
+  wiring_dds_timer1.c - DDS sample clock on Timer1
+  Part of the LGT8Fx core
+
+  Timer1 runs in CTC mode with OCR1A as top and clocks one DDS sample per
+  compare match, see wiring_dds.c.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+
+static void ddsTimer1Stop(void)
+{
+	TIMSK1 &= ~_BV(OCIE1A);
+
+	// back to the 8-bit phase correct pwm set up by init()
+	TCCR1B = 0;
+	TCCR1A = _BV(WGM10);
+	TCNT1 = 0;
+#if F_CPU >= 8000000L
+	TCCR1B = _BV(CS11) | _BV(CS10);
+#else
+	TCCR1B = _BV(CS11);
+#endif
+}
+
+uint32_t __ddsTimer1Start(uint32_t rate)
+{
+	uint8_t cs;
+	uint16_t top = __ddsTop(timerClock(1), rate, &cs);
+
+	TCCR1B = 0;
+	TCCR1A = 0;
+	TCNT1 = 0;
+	OCR1A = top;
+	TIFR1 = _BV(OCF1A);
+
+	__dds_stop = ddsTimer1Stop;
+	TIMSK1 |= _BV(OCIE1A);
+	TCCR1B = _BV(WGM12) | cs;
+
+	return ddsSampleRate();
+}
+
+ISR(TIMER1_COMPA_vect)
+{
+	__ddsTick();
+}
+
+#endif
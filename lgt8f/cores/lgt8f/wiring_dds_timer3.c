@@ -0,0 +1,57 @@
+/*
+  wiring_dds_timer3.c - DDS sample clock on Timer3
+  Part of the LGT8Fx core
+
+  Timer3 runs in CTC mode with OCR3A as top and clocks one DDS sample per
+  compare match, see wiring_dds.c. All Timer3 sources share one vector on
+  the LGT8FX8P, so this takes Timer3 away from any other user, and it is
+  left out with Tickless timekeeping, which has the vector for millis().
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8FX8P__) && defined(__DDS_TIMER3)
+
+static void ddsTimer3Stop(void)
+{
+	TIMSK3 &= ~_BV(OCIE3A);
+
+	// back to the 8-bit phase correct pwm set up by init()
+	TCCR3B = 0;
+	TCCR3A = _BV(WGM30);
+	TCNT3 = 0;
+	TCCR3B = _BV(CS31) | _BV(CS30);
+}
+
+uint32_t __ddsTimer3Start(uint32_t rate)
+{
+	uint8_t cs;
+	uint16_t top = __ddsTop(timerClock(3), rate, &cs);
+
+	TCCR3B = 0;
+	TCCR3A = 0;
+	TCNT3 = 0;
+	OCR3A = top;
+	TIFR3 = _BV(OCF3A);
+
+	__dds_stop = ddsTimer3Stop;
+	TIMSK3 |= _BV(OCIE3A);
+	TCCR3B = _BV(WGM32) | cs;
+
+	return ddsSampleRate();
+}
+
+ISR(TIMER3_vect)
+{
+	// shared vector, the flag is not cleared by hardware
+	TIFR3 = _BV(OCF3A);
+	__ddsTick();
+}
+
+#endif
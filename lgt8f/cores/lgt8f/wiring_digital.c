@@ -176,8 +176,96 @@ static void turnOffPWM(uint8_t timer)
 	}
 }
 
+#define PIN_TABLE_SIZE	sizeof(digital_pin_to_port_PGM)
+
+static pinHandle pinLookup(uint8_t pin)
+{
+	uint8_t port;
+
+	if (pin >= PIN_TABLE_SIZE)
+		return PIN_HANDLE_NONE;
+
+	port = digitalPinToPort(pin);
+	if (port == NOT_A_PIN)
+		return PIN_HANDLE_NONE;
+
+	return (uint8_t)(uint16_t)portInputRegister(port) |
+		((pinHandle)digitalPinToBitMask(pin) << 8);
+}
+
+#if LGT_PIN_CACHE
+// RAM copy of the PGM pin tables, so digitalWrite()/digitalRead() skip
+// the flash lookups; 3 bytes per pin
+typedef struct {
+	pinHandle handle;
+	uint8_t timer;
+} pin_cache_t;
+
+static pin_cache_t pin_cache[PIN_TABLE_SIZE];
+
+static void __attribute__((noinline)) pinCacheFill(void)
+{
+	uint8_t pin;
+
+	for (pin = 0; pin < PIN_TABLE_SIZE; pin++) {
+		pin_cache[pin].handle = pinLookup(pin);
+		pin_cache[pin].timer = digitalPinToTimer(pin);
+	}
+}
+
+// filled in by the startup code once .bss is cleared, before the C++
+// constructors, which may already call digitalWrite()
+void __pinCacheInit(void) \
+	__attribute__((naked)) \
+	__attribute__((section(".init5")));
+void __pinCacheInit(void)
+{
+	pinCacheFill();
+}
+#endif
+
+pinHandle pinResolve(uint8_t pin)
+{
+	uint8_t timer;
+
+	if (pin >= PIN_TABLE_SIZE)
+		return PIN_HANDLE_NONE;
+
+	timer = digitalPinToTimer(pin);
+	if (timer != NOT_ON_TIMER) turnOffPWM(timer);
+
+	return pinLookup(pin);
+}
+
+#if LGT_PIN_CACHE
 void digitalWrite(uint8_t pin, uint8_t val)
 {
+	PROFILE_CORE(PROFILE_DIGITAL_WRITE);
+	const pin_cache_t *c;
+
+	if (pin >= PIN_TABLE_SIZE) return;
+	c = &pin_cache[pin];
+
+	if (c->timer != NOT_ON_TIMER) turnOffPWM(c->timer);
+
+	pinWrite(c->handle, val);
+}
+
+int digitalRead(uint8_t pin)
+{
+	const pin_cache_t *c;
+
+	if (pin >= PIN_TABLE_SIZE) return LOW;
+	c = &pin_cache[pin];
+
+	if (c->timer != NOT_ON_TIMER) turnOffPWM(c->timer);
+
+	return pinRead(c->handle);
+}
+#else
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	PROFILE_CORE(PROFILE_DIGITAL_WRITE);
 	uint8_t timer = digitalPinToTimer(pin);
 	uint8_t bit = digitalPinToBitMask(pin);
 	uint8_t port = digitalPinToPort(pin);
@@ -218,6 +306,7 @@ int digitalRead(uint8_t pin)
 	if (*portInputRegister(port) & bit) return HIGH;
 	return LOW;
 }
+#endif
 
 void digitalToggle(uint8_t pin)
 {
@@ -0,0 +1,244 @@
+/*
+  wiring_parallel.c - parallel bus output and input
+  Part of the LGT8Fx core
+
+  See parallel_bus.h. The port layout is worked out in parallelBusBegin()
+  from the pin handles, so nothing here reads the pin tables per word.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#define PORT_IN(p)	((volatile uint8_t *)(uint16_t)(p)->in)
+#define PORT_DDR(p)	((volatile uint8_t *)(uint16_t)((p)->in + 1))
+#define PORT_OUT(p)	((volatile uint8_t *)(uint16_t)((p)->in + 2))
+
+uint8_t parallelBusBegin(parallel_bus_t *bus, const uint8_t *pins, uint8_t width, uint8_t strobe, uint8_t active)
+{
+	__parallel_port_t *p;
+	pinHandle h;
+	uint8_t i, n, bit;
+	int8_t shift;
+
+	memset(bus, 0, sizeof(*bus));
+
+	if (width == 0 || width > PARALLEL_BUS_WIDTH)
+		return 0;
+
+	for (i = 0; i < width; i++) {
+		h = pinResolve(pins[i]);
+		if (__pinHandleMask(h) == 0)
+			return 0;
+
+		for (n = 0; n < bus->nports; n++)
+			if (bus->port[n].in == (uint8_t)h)
+				break;
+		p = &bus->port[n];
+		if (n == bus->nports) {
+			bus->nports++;
+			p->in = (uint8_t)h;
+		}
+
+		for (bit = 0; !(__pinHandleMask(h) & _BV(bit)); bit++);
+		shift = i - bit;
+		if (p->mask == 0)
+			p->shift = shift;
+		else if (p->shift != shift)
+			p->shift = __PARALLEL_PERMUTED;
+		p->mask |= __pinHandleMask(h);
+
+		bus->bit_port[i] = n;
+		bus->bit_mask[i] = __pinHandleMask(h);
+	}
+
+#if defined(__LGT8FX8P__)
+	// as Pin<N>::mode() in fastio_pin.h does for these
+	for (i = 0; i < width; i++)
+		if (pins[i] == DAC0 || pins[i] == E0 || pins[i] == E2 || pins[i] == E6)
+			pinMode(pins[i], OUTPUT);
+#endif
+
+	for (n = 0; n < bus->nports; n++)
+		if (bus->port[n].shift == __PARALLEL_PERMUTED)
+			bus->permuted = 1;
+
+	bus->width = width;
+	bus->strobe = PIN_HANDLE_NONE;
+	if (strobe != PARALLEL_NO_STROBE) {
+		bus->strobe = pinResolve(strobe);
+		bus->strobe_active = active;
+		pinWrite(bus->strobe, !active);
+		pinMode(strobe, OUTPUT);
+	}
+
+	parallelBusMode(bus, OUTPUT);
+
+	return 1;
+}
+
+void parallelBusMode(parallel_bus_t *bus, uint8_t mode)
+{
+	__parallel_port_t *p;
+	uint8_t n;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	for (n = 0; n < bus->nports; n++) {
+		p = &bus->port[n];
+		if (mode == OUTPUT) {
+			*PORT_DDR(p) |= p->mask;
+		} else {
+			*PORT_DDR(p) &= ~p->mask;
+			if (mode == INPUT_PULLUP)
+				*PORT_OUT(p) |= p->mask;
+			else
+				*PORT_OUT(p) &= ~p->mask;
+		}
+	}
+	SREG = oldSREG;
+}
+
+static inline void busStrobe(parallel_bus_t *bus)
+{
+	volatile uint8_t *out = __pinHandleOut(bus->strobe);
+	uint8_t mask = __pinHandleMask(bus->strobe);
+
+	if (bus->strobe_active) {
+		*out |= mask;
+		*out &= ~mask;
+	} else {
+		*out &= ~mask;
+		*out |= mask;
+	}
+}
+
+// one word onto the pins, interrupts are off
+static void busOut(parallel_bus_t *bus, uint16_t val)
+{
+	__parallel_port_t *p;
+	uint8_t bits[PARALLEL_BUS_PORTS];
+	uint8_t n, i, out;
+	uint16_t v;
+
+	if (bus->permuted) {
+		memset(bits, 0, sizeof(bits));
+		v = val;
+		for (i = 0; i < bus->width; i++, v >>= 1)
+			if (v & 1)
+				bits[bus->bit_port[i]] |= bus->bit_mask[i];
+	}
+
+	for (n = 0; n < bus->nports; n++) {
+		p = &bus->port[n];
+
+		if (p->shift == 0)
+			out = val;
+		else if (p->shift == 8)
+			out = val >> 8;
+		else if (p->shift == __PARALLEL_PERMUTED)
+			out = bits[n];
+		else if (p->shift > 0)
+			out = val >> p->shift;
+		else
+			out = val << -p->shift;
+		out &= p->mask;
+
+		if (p->mask == 0xff)
+			*PORT_OUT(p) = out;
+		else
+			*PORT_OUT(p) = (*PORT_OUT(p) & ~p->mask) | out;
+	}
+
+	if (__pinHandleMask(bus->strobe))
+		busStrobe(bus);
+}
+
+void parallelBusWrite(parallel_bus_t *bus, uint16_t val)
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	busOut(bus, val);
+	SREG = oldSREG;
+}
+
+void parallelBusStrobe(parallel_bus_t *bus)
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	busStrobe(bus);
+	SREG = oldSREG;
+}
+
+uint16_t parallelBusRead(parallel_bus_t *bus)
+{
+	__parallel_port_t *p;
+	uint8_t in[PARALLEL_BUS_PORTS];
+	uint8_t n, i;
+	uint16_t val = 0;
+
+	// every port once, as close together as possible
+	for (n = 0; n < bus->nports; n++)
+		in[n] = *PORT_IN(&bus->port[n]);
+
+	for (n = 0; n < bus->nports; n++) {
+		p = &bus->port[n];
+		if (p->shift == __PARALLEL_PERMUTED)
+			continue;
+		if (p->shift >= 0)
+			val |= (uint16_t)(in[n] & p->mask) << p->shift;
+		else
+			val |= (in[n] & p->mask) >> -p->shift;
+	}
+
+	if (bus->permuted) {
+		for (i = 0; i < bus->width; i++) {
+			n = bus->bit_port[i];
+			if (bus->port[n].shift == __PARALLEL_PERMUTED && (in[n] & bus->bit_mask[i]))
+				val |= 1 << i;
+		}
+	}
+
+	return val;
+}
+
+// interrupts are let in between words, a word itself goes out whole
+void parallelBusWriteBuffer(parallel_bus_t *bus, const void *buf, uint16_t len)
+{
+	const uint8_t *b = buf;
+	uint16_t val;
+	uint8_t oldSREG;
+
+	while (len--) {
+		val = *b++;
+		if (bus->width > 8)
+			val |= *b++ << 8;
+		oldSREG = SREG;
+		cli();
+		busOut(bus, val);
+		SREG = oldSREG;
+	}
+}
+
+void parallelBusWriteBuffer_P(parallel_bus_t *bus, const void *buf, uint16_t len)
+{
+	const uint8_t *b = buf;
+	uint16_t val;
+	uint8_t oldSREG;
+
+	while (len--) {
+		val = pgm_read_byte(b++);
+		if (bus->width > 8)
+			val |= pgm_read_byte(b++) << 8;
+		oldSREG = SREG;
+		cli();
+		busOut(bus, val);
+		SREG = oldSREG;
+	}
+}
@@ -0,0 +1,208 @@
+/*
+  wiring_pcint.c - pin change interrupt dispatch
+  Part of the LGT8Fx core
+
+  See pcint.h. Each vector is its own copy of the dispatch with the
+  port, the mask register and the tables of its group as constants.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+static pcintFunc pcint_func[PCINT_GROUPS][8];
+static pcintHook pcint_hook[PCINT_GROUPS];
+static uint8_t pcint_rise[PCINT_GROUPS];
+static uint8_t pcint_fall[PCINT_GROUPS];
+volatile uint8_t __pcint_last[PCINT_GROUPS];
+
+static volatile uint8_t *const pcint_in[] = {
+	&PINB, &PINC, &PIND,
+#if PCINT_GROUPS > 3
+	&PINE,
+#endif
+#if PCINT_GROUPS > 4
+	&PINF,
+#endif
+};
+
+static volatile uint8_t *const pcint_msk[] = {
+	&PCMSK0, &PCMSK1, &PCMSK2,
+#if PCINT_GROUPS > 3
+	&PCMSK3,
+#endif
+#if PCINT_GROUPS > 4
+	&PCMSK4,
+#endif
+};
+
+// group of the pin and its bit, 0 when it has no pin change interrupt
+static uint8_t pcintLookup(uint8_t pin, uint8_t *group)
+{
+	uint8_t mask = __pinHandleMask(pinResolve(pin));
+
+	if (mask == 0)
+		return 0;
+
+	*group = digitalPinToPCICRbit(pin);
+	if (*group >= PCINT_GROUPS)
+		return 0;
+
+	return mask;
+}
+
+uint8_t attachPinChangeInterrupt(uint8_t pin, pcintFunc func, uint8_t mode)
+{
+	uint8_t group, mask, bit;
+	uint8_t oldSREG;
+
+	mask = pcintLookup(pin, &group);
+	if (mask == 0 || func == 0)
+		return 0;
+
+	for (bit = 0; !(mask & _BV(bit)); bit++);
+
+	oldSREG = SREG;
+	cli();
+	pcint_func[group][bit] = func;
+	pcint_rise[group] &= ~mask;
+	pcint_fall[group] &= ~mask;
+	if (mode != FALLING)
+		pcint_rise[group] |= mask;
+	if (mode != RISING)
+		pcint_fall[group] |= mask;
+	__pcintUnmask(group, pcint_msk[group], pcint_in[group], mask);
+	if (!(PCICR & _BV(group))) {
+		PCIFR = _BV(group);
+		PCICR |= _BV(group);
+	}
+	SREG = oldSREG;
+
+	return 1;
+}
+
+void detachPinChangeInterrupt(uint8_t pin)
+{
+	uint8_t group, mask;
+	uint8_t oldSREG;
+
+	mask = pcintLookup(pin, &group);
+	if (mask == 0)
+		return;
+
+	oldSREG = SREG;
+	cli();
+	*pcint_msk[group] &= ~mask;
+	pcint_rise[group] &= ~mask;
+	pcint_fall[group] &= ~mask;
+	if (*pcint_msk[group] == 0 && !pcint_hook[group])
+		PCICR &= ~_BV(group);
+	SREG = oldSREG;
+}
+
+void pinChangeInterruptMask(uint8_t pin, uint8_t enable)
+{
+	uint8_t group, mask;
+	uint8_t oldSREG;
+
+	mask = pcintLookup(pin, &group);
+	if (mask == 0 || !((pcint_rise[group] | pcint_fall[group]) & mask))
+		return;
+
+	oldSREG = SREG;
+	cli();
+	if (enable)
+		__pcintUnmask(group, pcint_msk[group], pcint_in[group], mask);
+	else
+		*pcint_msk[group] &= ~mask;
+	SREG = oldSREG;
+}
+
+// the vector of the pin's port stays on while a hook is set, the hook
+// unmasks its pin in PCMSKn itself; 0 takes it off again
+uint8_t pinChangeInterruptHook(uint8_t pin, pcintHook hook)
+{
+	uint8_t group;
+	uint8_t oldSREG;
+
+	if (pcintLookup(pin, &group) == 0)
+		return 0;
+
+	oldSREG = SREG;
+	cli();
+	pcint_hook[group] = hook;
+	if (hook) {
+		if (!(PCICR & _BV(group))) {
+			PCIFR = _BV(group);
+			PCICR |= _BV(group);
+		}
+	} else if (*pcint_msk[group] == 0) {
+		PCICR &= ~_BV(group);
+	}
+	SREG = oldSREG;
+
+	return 1;
+}
+
+// the state is stored before the callbacks run, so a callback that
+// unmasks its pin again leaves the level it found
+static inline void pcintEdges(uint8_t group, uint8_t state, uint8_t msk) \
+	__attribute__((always_inline));
+static inline void pcintEdges(uint8_t group, uint8_t state, uint8_t msk)
+{
+	PROFILE_CORE(PROFILE_ISR_PCINT);
+	uint8_t fire = (state ^ __pcint_last[group]) & msk;
+	pcintFunc *func = pcint_func[group];
+
+	__pcint_last[group] = state;
+	fire &= (state & pcint_rise[group]) | (~state & pcint_fall[group]);
+
+	for (; fire; fire >>= 1, state >>= 1, func++)
+		if (fire & 1)
+			(*func)(state & 1);
+}
+
+// the hook goes first, the port is read after it
+static inline void pcintDispatch(uint8_t group, volatile uint8_t *in, volatile uint8_t *pcmsk) \
+	__attribute__((always_inline));
+static inline void pcintDispatch(uint8_t group, volatile uint8_t *in, volatile uint8_t *pcmsk)
+{
+	pcintHook hook = pcint_hook[group];
+
+	if (hook)
+		(*hook)();
+	pcintEdges(group, *in, *pcmsk);
+}
+
+ISR(PCINT0_vect)
+{
+	pcintDispatch(0, &PINB, &PCMSK0);
+}
+
+ISR(PCINT1_vect)
+{
+	pcintDispatch(1, &PINC, &PCMSK1);
+}
+
+ISR(PCINT2_vect)
+{
+	pcintDispatch(2, &PIND, &PCMSK2);
+}
+
+#if PCINT_GROUPS > 3
+ISR(PCINT3_vect)
+{
+	pcintDispatch(3, &PINE, &PCMSK3);
+}
+#endif
+
+#if PCINT_GROUPS > 4
+ISR(PCINT4_vect)
+{
+	pcintDispatch(4, &PINF, &PCMSK4);
+}
+#endif
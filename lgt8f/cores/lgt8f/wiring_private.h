@@ -41,6 +41,141 @@ extern "C"{
 #define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
 #endif
 
+// set from the "ADC offset correction" board menu: 1 = OFR0/OFR1 hardware
+// compensation calibrated at init(), 0 = two conversions per analogRead()
+#ifndef LGT_ADC_OFR
+#define LGT_ADC_OFR 0
+#endif
+
+// set from the "Fast timer clock" board menu: 1 = Timer1/Timer3 run from
+// the doubled oscillator (F2XEN) from init() on
+#ifndef LGT_TIMER_F2X
+#define LGT_TIMER_F2X 0
+#endif
+
+// set from the "Timekeeping" board menu: 1 = millis()/micros() from a free
+// running Timer3 (LGT8FX8P), Timer0 is left to pwm
+#ifndef LGT_TIMER3_MILLIS
+#define LGT_TIMER3_MILLIS 0
+#endif
+
+// set from the "delay()" board menu: 1 = delay() waits in IDLE sleep
+#ifndef LGT_IDLE_DELAY
+#define LGT_IDLE_DELAY 0
+#endif
+
+// set from the "Digital pin cache" board menu: 1 = digitalWrite() and
+// digitalRead() use a RAM copy of the pin tables
+#ifndef LGT_PIN_CACHE
+#define LGT_PIN_CACHE 0
+#endif
+
+uint8_t adcSelect(uint8_t pin);
+volatile uint8_t *adcTriggerFlag(uint8_t trigger, uint8_t *mask);
+#if defined(__LGT8FX8P__) && LGT_ADC_OFR
+void adcOffsetInit(void);
+#endif
+
+// gain-error correction of a raw conversion
+static inline uint16_t adcGainCorrect(uint16_t val)
+{
+#if defined(__LGT8FX8E__)
+//	val -= (val >> 5);
+	val -= 0;
+#elif defined(__LGT8FX8P__)
+	val -= (val >> 7);
+#endif
+	return val;
+}
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+// Timer1/Timer3 (1 or 3) pwm moved over to a new timer clock, see
+// timerFastClock()
+void __pwmClock(uint8_t timer, uint32_t from, uint32_t to);
+
+// DDS state, shared by wiring_dds.c and the per timer interrupts
+extern volatile uint8_t *__dds_dal;
+extern const uint8_t * volatile __dds_table;
+extern uint32_t __dds_phase;
+extern volatile uint32_t __dds_step;
+extern uint8_t __dds_next;
+extern uint8_t * volatile __dds_buf;
+extern uint8_t __dds_len;
+extern volatile uint8_t __dds_head;
+extern volatile uint8_t __dds_tail;
+extern volatile uint16_t __dds_underruns;
+extern void (*__dds_stop)(void);
+
+uint16_t __ddsTop(uint32_t clock, uint32_t rate, uint8_t *cs);
+
+// one sample period, called from the timer interrupt
+static inline void __ddsTick(void)
+{
+	uint8_t tail;
+	uint32_t phase;
+
+	// the sample worked out last time goes out first, so the DAC update
+	// does not move with the path taken below
+#if defined(__LGT8FX8P__)
+	DAL0 = __dds_next;
+#else
+	*__dds_dal = __dds_next;
+#endif
+
+	if (__dds_buf) {
+		tail = __dds_tail;
+		if (tail == __dds_head) {
+			if (__dds_underruns != 0xffff)
+				__dds_underruns++;
+			return;
+		}
+		__dds_next = __dds_buf[tail];
+		if (++tail == __dds_len)
+			tail = 0;
+		__dds_tail = tail;
+	} else {
+		phase = __dds_phase + __dds_step;
+		__dds_phase = phase;
+		__dds_next = pgm_read_byte(__dds_table + (uint8_t)(phase >> 24));
+	}
+}
+#endif
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+// input capture state per timer, index 0 Timer1 and 1 Timer3, shared by
+// wiring_capture.c and the per timer interrupts
+typedef struct {
+	capture_edge_t *buf;
+	uint8_t len;
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	volatile uint16_t overruns;
+	uint8_t change;		// CHANGE mode, the edge flips after each capture
+	void (*stop)(void);
+} __capture_t;
+
+extern __capture_t __capture[2];
+
+static inline void __capturePush(__capture_t *c, uint32_t time, uint8_t level)
+{
+	uint8_t head = c->head;
+	uint8_t next = head + 1;
+
+	if (next == c->len)
+		next = 0;
+
+	if (next == c->tail) {
+		if (c->overruns != 0xffff)
+			c->overruns++;
+		return;
+	}
+
+	c->buf[head].time = time;
+	c->buf[head].level = level;
+	c->head = next;
+}
+#endif
+
 uint32_t countPulseASM(volatile uint8_t *port, uint8_t bit, uint8_t stateMask, unsigned long maxloops);
 
 #define EXTERNAL_INT_0 0
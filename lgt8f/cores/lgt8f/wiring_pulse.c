@@ -41,13 +41,26 @@ unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout)
 
 	// convert the timeout from microseconds to a number of times through
 	// the initial loop; it takes approximately 16 clock cycles per iteration
+#if LGT_UDSC && defined(__LGT8FX8P__)
+	unsigned long maxloops;
+	if (UDSC_IS_POW2(clockCyclesPerMicrosecond()))
+		maxloops = microsecondsToClockCycles(timeout)/16;
+	else
+		maxloops = udscMul32x16(timeout, clockCyclesPerMicrosecond())/16;
+#else
 	unsigned long maxloops = microsecondsToClockCycles(timeout)/16;
+#endif
 
 	unsigned long width = countPulseASM(portInputRegister(port), bit, stateMask, maxloops);
 
 	// prevent clockCyclesToMicroseconds to return bogus values if countPulseASM timed out
-	if (width)
+	if (width) {
+#if LGT_UDSC && defined(__LGT8FX8P__)
+		if (!UDSC_IS_POW2(clockCyclesPerMicrosecond()))
+			return udscDiv32(width * 16 + 16, clockCyclesPerMicrosecond());
+#endif
 		return clockCyclesToMicroseconds(width * 16 + 16);
+	}
 	else
 		return 0;
 }
@@ -0,0 +1,513 @@
+/*
+  wiring_pwm.c - high resolution pwm on the 16 bit timers
+  Part of the LGT8Fx core
+
+  init() leaves Timer1 and Timer3 in 8-bit phase correct mode at clk/64,
+  which is what analogWrite() expects. analogWriteFrequency() moves a
+  timer to fast pwm with ICR1/ICR3 as top instead, so frequency and
+  resolution trade against each other: top + 1 timer clocks per period,
+  and the returned resolution is the number of whole bits that gives.
+
+  analogWriteHR() takes a 16 bit duty and scales it to the current top,
+  the duties are kept so a later frequency change can rescale them.
+  Both channels of a timer share its frequency, and analogWrite() on a
+  timer in this mode writes raw compare values. Timer0 is left alone.
+  Periods are counted in timerClock() ticks; timerFastClock() sets the
+  prescaler and top of a running timer again so its frequency stays, and
+  moves the init() mode to 9 or 10 bit phase correct where no prescaler
+  matches, which analogWrite() scales its duty up to.
+
+  halfBridgeBegin() runs the same mode with the LGT8FX8P dead-time unit
+  on: OC1B/OC3B carry the complement of OC1A/OC3A, each edge delayed by
+  DTR1/DTR3 timer clocks. With a comparator fault AC0 is switched on,
+  comparing AIN0 (D6) against AIN1 (D7), and DOC1A/DOC1B (DOC30/DOC31)
+  let it switch both outputs off in hardware when AIN0 rises above AIN1;
+  halfBridgeFault() sees the comparator flag and holds the outputs off
+  until halfBridgeResume(). An external interrupt fault switches them
+  off from its interrupt.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+
+#if defined(TCCR3A)
+#define PWM_TIMERS	2
+#define PWM_CHANNELS	5
+#else
+#define PWM_TIMERS	1
+#define PWM_CHANNELS	2
+#endif
+
+// clock select 1..5 divides the timer clock by 1, 8, 64, 256, 1024
+static const uint8_t pwm_shift[] = { 0, 3, 6, 8, 10 };
+
+// top of each timer, 0 while it is still in the init() 8 bit mode
+static uint16_t pwm_top[PWM_TIMERS];
+static uint8_t pwm_cs[PWM_TIMERS];
+static uint16_t pwm_duty[PWM_CHANNELS];
+
+// 0/1 are Timer1 A/B, 2..4 are Timer3 A/B/C
+static int8_t pwmChannel(uint8_t pin)
+{
+	switch (digitalPinToTimer(pin)) {
+	case TIMER1A:	return 0;
+	case TIMER1B:	return 1;
+#if defined(TCCR3A)
+	case TIMER3A:	return 2;
+	case TIMER3B:	return 3;
+	case TIMER3C:	return 4;
+#endif
+	}
+	return -1;
+}
+
+static volatile uint16_t *pwmOCR(uint8_t ch)
+{
+	switch (ch) {
+	case 0:		return &OCR1A;
+	case 1:		return &OCR1B;
+#if defined(TCCR3A)
+	case 2:		return &OCR3A;
+	case 3:		return &OCR3B;
+	case 4:		return &OCR3C;
+#endif
+	}
+	return 0;
+}
+
+static void pwmConnect(uint8_t ch)
+{
+	switch (ch) {
+	case 0:	sbi(TCCR1A, COM1A1);	break;
+	case 1:	sbi(TCCR1A, COM1B1);	break;
+#if defined(TCCR3A)
+	// D1/D2 share their pin with OC3A/OC3B on PF1/PF2, see analogWrite()
+	case 2:
+		sbi(TCCR3A, COM3A1);
+#if !defined(__LGT8FX8P48__)
+		cbi(DDRD, DDD1);
+#endif
+		sbi(DDRF, DDF1);
+		break;
+	case 3:
+		sbi(TCCR3A, COM3B1);
+#if !defined(__LGT8FX8P48__)
+		cbi(DDRD, DDD2);
+#endif
+		sbi(DDRF, DDF2);
+		break;
+	case 4:
+		sbi(TCCR3A, COM3C1);
+		sbi(DDRF, DDF3);
+		break;
+#endif
+	}
+}
+
+static void pwmUpdate(uint8_t ch)
+{
+	uint16_t top = pwm_top[ch >= 2];
+	uint8_t oldSREG = SREG;
+
+	cli();
+	*pwmOCR(ch) = ((uint32_t)pwm_duty[ch] * ((uint32_t)top + 1)) >> 16;
+	SREG = oldSREG;
+}
+
+// the timer is held while ICR and the compare values change, so no
+// period runs against a top it has already passed
+static void pwmSetup(uint8_t timer, uint16_t top, uint8_t cs)
+{
+	uint8_t ch;
+	uint8_t oldSREG = SREG;
+
+	cli();
+	if (timer == 0) {
+		TCCR1B = 0;
+		TCCR1A = (TCCR1A & 0xf0) | _BV(WGM11);
+		TCNT1 = 0;
+		ICR1 = top;
+	}
+#if defined(TCCR3A)
+	else {
+		TCCR3B = 0;
+		TCCR3A = (TCCR3A & 0xfc) | _BV(WGM31);
+		TCNT3 = 0;
+		ICR3 = top;
+	}
+#endif
+	pwm_top[timer] = top;
+	pwm_cs[timer] = cs;
+	SREG = oldSREG;
+
+	for (ch = timer ? 2 : 0; ch < (timer ? PWM_CHANNELS : 2); ch++)
+		pwmUpdate(ch);
+
+	if (timer == 0)
+		TCCR1B = _BV(WGM13) | _BV(WGM12) | cs;
+#if defined(TCCR3A)
+	else
+		TCCR3B = _BV(WGM33) | _BV(WGM32) | cs;
+#endif
+}
+
+// a period of ticks timer clocks on the smallest prescaler that fits it
+// into 16 bits, returns the top + 1 it got
+static uint32_t pwmPeriod(uint8_t timer, uint32_t ticks)
+{
+	uint32_t cycles = 0;
+	uint8_t i;
+
+	for (i = 0; i < sizeof(pwm_shift); i++) {
+		cycles = ticks >> pwm_shift[i];
+		if (cycles <= 65536UL)
+			break;
+	}
+	if (i == sizeof(pwm_shift)) {
+		i--;
+		cycles = 65536UL;
+	}
+	if (cycles < 4)
+		cycles = 4;
+
+	pwmSetup(timer, cycles - 1, i + 1);
+
+	return cycles;
+}
+
+uint8_t analogWriteFrequency(uint8_t pin, uint32_t hz)
+{
+	int8_t ch = pwmChannel(pin);
+	uint32_t cycles;
+	uint8_t bits;
+
+	if (ch < 0 || hz == 0)
+		return 0;
+
+	cycles = pwmPeriod(ch >= 2, timerClock(ch >= 2 ? 3 : 1) / hz);
+
+	for (bits = 2; bits < 16 && ((uint32_t)2 << bits) <= cycles; bits++);
+
+	return bits;
+}
+
+void analogWriteHR(uint8_t pin, uint16_t duty)
+{
+	int8_t ch = pwmChannel(pin);
+
+	if (ch < 0) {
+		analogWrite(pin, duty >> 8);
+		return;
+	}
+
+	// full 16 bit at clk/1 unless a frequency was set
+	if (!pwm_top[ch >= 2])
+		pwmSetup(ch >= 2, 0xffff, 1);
+
+	pinMode(pin, OUTPUT);
+	pwm_duty[ch] = duty;
+
+	if (duty == 0 || duty == 0xffff) {
+		// fast pwm still gives a one clock pulse at either end
+		digitalWrite(pin, duty ? HIGH : LOW);
+		return;
+	}
+
+	pwmUpdate(ch);
+	pwmConnect(ch);
+}
+
+// the init() mode as phase correct pwm with an 8, 9 or 10 bit top
+// (WGMn1:0 = 1, 2, 3) and the prescaler that keeps its period when the
+// timer clock changes by 2^k, within 0.3% as 2 * top is not a power of 2
+static void pwmClockInit(uint8_t timer, int8_t k)
+{
+	volatile uint8_t *tccra = &TCCR1A, *tccrb = &TCCR1B;
+	uint8_t bits, cs, nbits, i, ch;
+	int8_t e;
+
+#if defined(TCCR3A)
+	if (timer) {
+		tccra = &TCCR3A;
+		tccrb = &TCCR3B;
+	}
+#endif
+	// WGMn3:2 and CSn2:0 sit at the same bits in TCCR1B and TCCR3B
+	bits = *tccra & 3;
+	cs = *tccrb & 0x07;
+	if (bits == 0 || (*tccrb & (_BV(WGM13) | _BV(WGM12))) || cs == 0 || cs > 5)
+		return;
+
+	// the period is about 2^e timer clocks, 2^(bits + 8) ahead of the
+	// prescaler
+	e = bits + 8 + pwm_shift[cs - 1] + k;
+	for (nbits = 1; nbits <= 3; nbits++) {
+		for (i = 0; i < sizeof(pwm_shift); i++)
+			if (pwm_shift[i] + nbits + 8 == e)
+				break;
+		if (i < sizeof(pwm_shift))
+			break;
+	}
+	if (nbits > 3)
+		return;
+
+	*tccra = (*tccra & ~3) | nbits;
+	*tccrb = (*tccrb & ~0x07) | (i + 1);
+	for (ch = timer ? 2 : 0; ch < (timer ? PWM_CHANNELS : 2); ch++) {
+		volatile uint16_t *ocr = pwmOCR(ch);
+		*ocr = (nbits > bits) ? *ocr << (nbits - bits) : *ocr >> (bits - nbits);
+	}
+}
+
+// timerFastClock() changed the clock of Timer1/Timer3 from one power of 2
+// to another with interrupts off; the pwm keeps its frequency
+void __pwmClock(uint8_t timer, uint32_t from, uint32_t to)
+{
+	uint32_t ticks;
+	uint8_t shift, tccrb = TCCR1B;
+
+	timer = (timer == 3);
+	if (timer >= PWM_TIMERS)
+		return;
+#if defined(TCCR3A)
+	if (timer)
+		tccrb = TCCR3B;
+#endif
+
+	// fast pwm with ICR top is the mode of analogWriteFrequency()
+	if (!pwm_top[timer] || !(tccrb & (_BV(WGM13) | _BV(WGM12)))) {
+		int8_t k = 0;
+
+		for (ticks = from; ticks < to; ticks <<= 1, k++);
+		for (; ticks > to; ticks >>= 1, k--);
+		pwmClockInit(timer, k);
+		return;
+	}
+
+	shift = pwm_shift[pwm_cs[timer] - 1];
+	ticks = ((uint32_t)pwm_top[timer] + 1) << shift;
+	if (to > from)
+		ticks *= to / from;
+	else
+		ticks /= from / to;
+	pwmPeriod(timer, ticks);
+
+#if defined(__LGT8FX8P__)
+	// the dead time is counted after the prescaler too
+	if ((timer ? TCCR3C & _BV(DTEN3) : TCCR1C & _BV(DTEN1))) {
+		uint8_t nshift = pwm_shift[pwm_cs[timer] - 1];
+		uint32_t dt = (uint32_t)(timer ? DTR3L : DTR1L) << shift;
+
+		if (to > from)
+			dt *= to / from;
+		else
+			dt /= from / to;
+		dt = (dt + _BV(nshift) - 1) >> nshift;
+		if (dt > 255)
+			dt = 255;
+		if (timer == 0) {
+			DTR1L = dt;
+			DTR1H = dt;
+		} else {
+			DTR3L = dt;
+			DTR3H = dt;
+		}
+	}
+#endif
+}
+
+#if defined(__LGT8FX8P__)
+
+static uint8_t bridge_int;		// HALF_BRIDGE_FAULT_* per timer
+static volatile uint8_t bridge_tripped;	// bit per timer
+
+// both outputs low, so neither switch of the bridge conducts
+static void bridgeOff(uint8_t timer)
+{
+	if (timer == 0) {
+		TCCR1A &= ~(_BV(COM1A1) | _BV(COM1B1));
+		PORTB &= ~(_BV(PB1) | _BV(PB2));
+	} else {
+		TCCR3A &= ~(_BV(COM3A1) | _BV(COM3B1));
+		PORTF &= ~(_BV(PF1) | _BV(PF2));
+	}
+}
+
+static void bridgeOn(uint8_t timer)
+{
+	pwmConnect(timer ? 2 : 0);
+	pwmConnect(timer ? 3 : 1);
+}
+
+// only the bridges wired to the interrupt that fired
+static void bridgeTrip(uint8_t fault)
+{
+	uint8_t timer;
+
+	for (timer = 0; timer < PWM_TIMERS; timer++) {
+		if (((bridge_int >> (4 * timer)) & 0x0f) == fault) {
+			bridgeOff(timer);
+			bridge_tripped |= _BV(timer);
+		}
+	}
+}
+
+static void bridgeTripInt0(void)
+{
+	bridgeTrip(HALF_BRIDGE_FAULT_INT0);
+}
+
+static void bridgeTripInt1(void)
+{
+	bridgeTrip(HALF_BRIDGE_FAULT_INT1);
+}
+
+// dead time in timer clocks, rounded up and limited to the 8 bit DTRn
+static uint8_t bridgeDeadTime(uint8_t timer, uint16_t ns)
+{
+	uint32_t clk = (timerClock(timer ? 3 : 1) >> pwm_shift[pwm_cs[timer] - 1]) / 1000UL;
+	uint32_t ticks = ((uint32_t)ns * clk + 999999UL) / 1000000UL;
+
+	return (ticks > 255) ? 255 : ticks;
+}
+
+uint8_t halfBridgeBegin(uint8_t pin, uint32_t hz, uint16_t deadtime, uint8_t fault)
+{
+	int8_t ch = pwmChannel(pin);
+	uint8_t timer = (ch >= 2);
+	uint8_t bits, dt, doc;
+
+	if ((ch != 0 && ch != 2) || fault > HALF_BRIDGE_FAULT_INT1)
+		return 0;
+
+	halfBridgeEnd(pin);
+
+	pwm_duty[ch] = 0;
+	bits = analogWriteFrequency(pin, hz);
+	if (!bits)
+		return 0;
+
+	dt = bridgeDeadTime(timer, deadtime);
+	doc = (fault == HALF_BRIDGE_FAULT_AC);
+
+	if (timer == 0) {
+		DTR1L = dt;
+		DTR1H = dt;
+		TCCR1C = _BV(DTEN1) | (doc ? _BV(DOC1A) | _BV(DOC1B) : 0);
+		DDRB |= _BV(DDB1) | _BV(DDB2);
+	} else {
+		DTR3L = dt;
+		DTR3H = dt;
+		TCCR3C = _BV(DTEN3) | (doc ? _BV(DOC30) | _BV(DOC31) : 0);
+	}
+
+	bridge_int |= fault << (4 * timer);
+	if (doc) {
+		// AC0 on, AIN0 against AIN1, flag on the rising output; both
+		// bridges share it
+		C0SR = _BV(C0I) | _BV(C0IS1) | _BV(C0IS0);
+	} else if (fault >= HALF_BRIDGE_FAULT_INT0) {
+		attachInterrupt(fault - HALF_BRIDGE_FAULT_INT0,
+			fault == HALF_BRIDGE_FAULT_INT0 ? bridgeTripInt0 : bridgeTripInt1, FALLING);
+	}
+
+	bridgeOn(timer);
+
+	return bits;
+}
+
+void halfBridgeWrite(uint8_t pin, uint16_t duty)
+{
+	int8_t ch = pwmChannel(pin);
+
+	if (ch != 0 && ch != 2)
+		return;
+
+	pwm_duty[ch] = duty;
+	pwmUpdate(ch);
+}
+
+// the comparator cuts the outputs without an interrupt, its flag is
+// taken over here and the bridges on it are held off in software too
+static void bridgePollAC(void)
+{
+	if (C0SR & _BV(C0I)) {
+		bridgeTrip(HALF_BRIDGE_FAULT_AC);
+		C0SR |= _BV(C0I);
+	}
+}
+
+uint8_t halfBridgeFault(uint8_t pin)
+{
+	uint8_t timer = (pwmChannel(pin) >= 2);
+	uint8_t oldSREG = SREG;
+
+	cli();
+	if (((bridge_int >> (4 * timer)) & 0x0f) == HALF_BRIDGE_FAULT_AC)
+		bridgePollAC();
+	SREG = oldSREG;
+
+	return (bridge_tripped >> timer) & 1;
+}
+
+// after an interrupt fault, the cause has to be gone before this; a
+// comparator fault stays while AIN0 is still above AIN1
+void halfBridgeResume(uint8_t pin)
+{
+	int8_t ch = pwmChannel(pin);
+	uint8_t timer = (ch >= 2);
+	uint8_t ac, oldSREG = SREG;
+
+	if (ch != 0 && ch != 2)
+		return;
+
+	ac = (((bridge_int >> (4 * timer)) & 0x0f) == HALF_BRIDGE_FAULT_AC);
+
+	cli();
+	if (ac)
+		bridgePollAC();
+	if ((bridge_tripped & _BV(timer)) && !(ac && (C0SR & _BV(C0O)))) {
+		bridge_tripped &= ~_BV(timer);
+		bridgeOn(timer);
+	}
+	SREG = oldSREG;
+}
+
+void halfBridgeEnd(uint8_t pin)
+{
+	int8_t ch = pwmChannel(pin);
+	uint8_t timer = (ch >= 2);
+	uint8_t fault;
+
+	if (ch != 0 && ch != 2)
+		return;
+
+	fault = (bridge_int >> (4 * timer)) & 0x0f;
+	bridge_int &= ~(0x0f << (4 * timer));
+	bridge_tripped &= ~_BV(timer);
+	// the interrupt or comparator stays on while the other bridge still
+	// uses it
+	if (fault && ((bridge_int >> (4 * !timer)) & 0x0f) != fault) {
+		if (fault == HALF_BRIDGE_FAULT_AC)
+			C0SR = _BV(C0D);
+		else
+			detachInterrupt(fault - HALF_BRIDGE_FAULT_INT0);
+	}
+
+	bridgeOff(timer);
+	if (timer == 0)
+		TCCR1C = 0;
+	else
+		TCCR3C = 0;
+}
+
+#endif
+
+#endif
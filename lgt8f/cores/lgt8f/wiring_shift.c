@@ -21,36 +21,293 @@
 */
 
 #include "wiring_private.h"
+#include "pins_arduino.h"
+#include <util/delay_basic.h>
 
-uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder) {
+// shiftOut()/shiftIn() take the SPI unit when the pins are SCK and MOSI
+// (MISO for shiftIn), and USART0 in master SPI mode when shiftOut() runs
+// on XCK0 (D4) and TXD0 (D1) while Serial is not started. The clock is
+// then the fastest one up to shiftClock() (4MHz by default). Other pins
+// are bit-banged on resolved pin handles, so the pin tables are only
+// read once per call, with each half clock period paced to shiftClock()
+// (500kHz by default, about the digitalWrite() version, and no slower
+// than F_CPU / 1536).
+//
+// The bit timing follows the digitalWrite() version: shiftOut() sets the
+// data half a period before the rising clock edge (SPI mode 0), shiftIn()
+// samples half a period after it, while the clock is still high (mode
+// 1). The hardware SPI is only taken while SS is
+// an output or reads high, so the unit cannot fall back to slave mode;
+// SPCR/SPSR are put back afterwards.
+
+#define PIN_XCK0	4
+#define PIN_TXD0	1
+
+#define SHIFT_SOFT	0
+#define SHIFT_SPI	1
+#define SHIFT_USART	2
+
+#define SHIFT_CLOCK_HW		4000000UL
+#define SHIFT_CLOCK_SOFT	500000UL
+
+// 0 until shiftClock() is called, then it holds for every path
+static uint32_t shift_clock;
+
+void shiftClock(uint32_t hz)
+{
+	shift_clock = hz;
+}
+
+static uint32_t shiftHz(uint32_t dflt)
+{
+	return shift_clock ? shift_clock : dflt;
+}
+
+static uint8_t shiftPath(uint8_t dataPin, uint8_t clockPin, uint8_t in)
+{
+#if defined(SPCR)
+	if (clockPin == SCK && dataPin == (in ? MISO : MOSI) &&
+	    ((*portModeRegister(digitalPinToPort(SS)) | *portInputRegister(digitalPinToPort(SS))) &
+	     digitalPinToBitMask(SS)))
+		return SHIFT_SPI;
+#endif
+#if defined(UCSR0C) && defined(UMSEL01)
+	if (!in && clockPin == PIN_XCK0 && dataPin == PIN_TXD0 &&
+	    !(UCSR0B & (_BV(RXEN0) | _BV(TXEN0))))
+		return SHIFT_USART;
+#endif
+	return SHIFT_SOFT;
+}
+
+#if defined(SPCR)
+static void spiBegin(uint8_t bitOrder, uint8_t in, uint8_t *saved)
+{
+	uint32_t hz = shiftHz(SHIFT_CLOCK_HW);
+	uint8_t div, spcr;
+
+	saved[0] = SPCR;
+	saved[1] = SPSR;
+
+	// F_CPU / 2 << div, with SPI2X: 2, 4, 8, 16, 32, 64, 128
+	for (div = 0; div < 6 && (F_CPU >> (div + 1)) > hz; div++);
+
+	spcr = _BV(SPE) | _BV(MSTR) | (div >> 1);
+	if (bitOrder == LSBFIRST)
+		spcr |= _BV(DORD);
+	if (in)
+		spcr |= _BV(CPHA);
+
+	pinMode(SCK, OUTPUT);
+	if (!in)
+		pinMode(MOSI, OUTPUT);
+	SPCR = spcr;
+	SPSR = (div & 1) || div == 6 ? 0 : _BV(SPI2X);
+}
+
+static void spiEnd(const uint8_t *saved)
+{
+	SPCR = saved[0];
+	SPSR = saved[1];
+}
+
+static inline uint8_t spiTransfer(uint8_t val)
+{
+	SPDR = val;
+	while (!(SPSR & _BV(SPIF)));
+	return SPDR;
+}
+#endif
+
+#if defined(UCSR0C) && defined(UMSEL01)
+static uint8_t usartBegin(uint8_t bitOrder)
+{
+	uint8_t saved = UCSR0C;
+	uint32_t hz = shiftHz(SHIFT_CLOCK_HW);
+	uint32_t ubrr = (F_CPU / 2 + hz - 1) / hz;
+
+	// master SPI clock is F_CPU / (2 * (UBRR0 + 1))
+	if (ubrr > 4096)
+		ubrr = 4096;
+	if (ubrr > 0)
+		ubrr--;
+
+	UBRR0 = 0;
+	pinMode(PIN_XCK0, OUTPUT);
+	UCSR0C = _BV(UMSEL01) | _BV(UMSEL00) | (bitOrder == LSBFIRST ? _BV(UDORD0) : 0);
+	UCSR0B = _BV(TXEN0);
+	UBRR0 = ubrr;
+
+	return saved;
+}
+
+static void usartEnd(uint8_t saved)
+{
+	// the last byte has to leave the shift register first
+	while (!(UCSR0A & _BV(TXC0)));
+	UCSR0B = 0;
+	UCSR0C = saved;
+}
+
+static inline void usartWrite(uint8_t val)
+{
+	while (!(UCSR0A & _BV(UDRE0)));
+	UCSR0A = _BV(TXC0);
+	UDR0 = val;
+}
+#endif
+
+// _delay_loop_1() counts of half a clock period, 3 clocks each; 0 runs
+// the loop bare
+static uint8_t softHalfPeriod(void)
+{
+	uint32_t n = F_CPU / 6 / shiftHz(SHIFT_CLOCK_SOFT);
+
+	return (n > 255) ? 255 : n;
+}
+
+static inline void softDelay(uint8_t n)
+{
+	if (n)
+		_delay_loop_1(n);
+}
+
+// each port write is atomic on its own, an interrupt in between only
+// stretches the clock
+static inline void softSet(volatile uint8_t *port, uint8_t mask, uint8_t on)
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+	if (on)
+		*port |= mask;
+	else
+		*port &= ~mask;
+	SREG = oldSREG;
+}
+
+static uint8_t softShiftIn(pinHandle data, pinHandle clock, uint8_t bitOrder, uint8_t half)
+{
+	volatile uint8_t *clk = __pinHandleOut(clock);
+	volatile uint8_t *in = __pinHandleIn(data);
+	uint8_t cmask = __pinHandleMask(clock);
+	uint8_t dmask = __pinHandleMask(data);
 	uint8_t value = 0;
 	uint8_t i;
 
 	for (i = 0; i < 8; ++i) {
-		digitalWrite(clockPin, HIGH);
+		softSet(clk, cmask, 1);
+		softDelay(half);
 		if (bitOrder == LSBFIRST)
-			value |= digitalRead(dataPin) << i;
+			value = (value >> 1) | ((*in & dmask) ? 0x80 : 0);
 		else
-			value |= digitalRead(dataPin) << (7 - i);
-		digitalWrite(clockPin, LOW);
+			value = (value << 1) | ((*in & dmask) ? 1 : 0);
+		softSet(clk, cmask, 0);
+		softDelay(half);
 	}
+
 	return value;
 }
 
-void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val)
+static void softShiftOut(pinHandle data, pinHandle clock, uint8_t bitOrder, uint8_t val, uint8_t half)
 {
-	uint8_t i;
+	volatile uint8_t *clk = __pinHandleOut(clock);
+	volatile uint8_t *out = __pinHandleOut(data);
+	uint8_t cmask = __pinHandleMask(clock);
+	uint8_t dmask = __pinHandleMask(data);
+	uint8_t i, bit;
 
 	for (i = 0; i < 8; i++)  {
 		if (bitOrder == LSBFIRST) {
-			digitalWrite(dataPin, val & 1);
+			bit = val & 1;
 			val >>= 1;
-		} else {	
-			digitalWrite(dataPin, (val & 128) != 0);
+		} else {
+			bit = val & 128;
 			val <<= 1;
 		}
-			
-		digitalWrite(clockPin, HIGH);
-		digitalWrite(clockPin, LOW);		
+		softSet(out, dmask, bit);
+		softDelay(half);
+		softSet(clk, cmask, 1);
+		softDelay(half);
+		softSet(clk, cmask, 0);
 	}
 }
+
+void shiftInBuffer(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t *buf, uint16_t len)
+{
+	pinHandle data, clock;
+	uint8_t half;
+#if defined(SPCR)
+	uint8_t saved[2];
+#endif
+
+	if (len == 0)
+		return;
+
+#if defined(SPCR)
+	if (shiftPath(dataPin, clockPin, 1) == SHIFT_SPI) {
+		spiBegin(bitOrder, 1, saved);
+		while (len--)
+			*buf++ = spiTransfer(0xff);
+		spiEnd(saved);
+		return;
+	}
+#endif
+
+	data = pinResolve(dataPin);
+	clock = pinResolve(clockPin);
+	half = softHalfPeriod();
+	while (len--)
+		*buf++ = softShiftIn(data, clock, bitOrder, half);
+}
+
+void shiftOutBuffer(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, const uint8_t *buf, uint16_t len)
+{
+	pinHandle data, clock;
+	uint8_t half;
+#if defined(SPCR)
+	uint8_t saved[2];
+#endif
+#if defined(UCSR0C) && defined(UMSEL01)
+	uint8_t ucsr0c;
+#endif
+
+	if (len == 0)
+		return;
+
+	switch (shiftPath(dataPin, clockPin, 0)) {
+#if defined(SPCR)
+	case SHIFT_SPI:
+		spiBegin(bitOrder, 0, saved);
+		while (len--)
+			spiTransfer(*buf++);
+		spiEnd(saved);
+		return;
+#endif
+#if defined(UCSR0C) && defined(UMSEL01)
+	case SHIFT_USART:
+		ucsr0c = usartBegin(bitOrder);
+		while (len--)
+			usartWrite(*buf++);
+		usartEnd(ucsr0c);
+		return;
+#endif
+	}
+
+	data = pinResolve(dataPin);
+	clock = pinResolve(clockPin);
+	half = softHalfPeriod();
+	while (len--)
+		softShiftOut(data, clock, bitOrder, *buf++, half);
+}
+
+uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder) {
+	uint8_t value;
+
+	shiftInBuffer(dataPin, clockPin, bitOrder, &value, 1);
+	return value;
+}
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val)
+{
+	shiftOutBuffer(dataPin, clockPin, bitOrder, &val, 1);
+}
@@ -124,7 +124,10 @@ bool SoftwareSerial::listen()
     _receive_buffer_head = _receive_buffer_tail = 0;
     active_object = this;
 
+    uint8_t oldSREG = SREG;
+    cli();
     setRxIntMsk(true);
+    SREG = oldSREG;
     return true;
   }
 
@@ -250,24 +253,14 @@ inline void SoftwareSerial::handle_interrupt()
   }
 }
 
-#if defined(PCINT0_vect)
-ISR(PCINT0_vect)
+// The PCINT vectors belong to the core (pcint.h), this is the hook at
+// the head of the vector of the receive pin's port, ahead of the per pin
+// dispatch. It runs on any pin change of that port, recv() checks for
+// the start bit, as with a vector of its own.
+static void pcint_recv()
 {
   SoftwareSerial::handle_interrupt();
 }
-#endif
-
-#if defined(PCINT1_vect)
-ISR(PCINT1_vect, ISR_ALIASOF(PCINT0_vect));
-#endif
-
-#if defined(PCINT2_vect)
-ISR(PCINT2_vect, ISR_ALIASOF(PCINT0_vect));
-#endif
-
-#if defined(PCINT3_vect)
-ISR(PCINT3_vect, ISR_ALIASOF(PCINT0_vect));
-#endif
 
 //
 // Constructor
@@ -333,15 +326,11 @@ void SoftwareSerial::begin(uint16_t rxcenter, uint16_t  rxintra, uint16_t  rxsto
   _tx_delay = tx;
 
   // Only setup rx when we have a valid PCINT for this pin
-  if (digitalPinToPCICR((int8_t)_receivePin)) {
+  if (attachRx()) {
     _rx_delay_centering = rxcenter;
     _rx_delay_intrabit = rxintra;
     _rx_delay_stopbit = rxstop;
 
-    *digitalPinToPCICR((int8_t)_receivePin) |= _BV(digitalPinToPCICRbit(_receivePin));
-    _pcint_maskreg = digitalPinToPCMSK(_receivePin);
-    _pcint_maskvalue = _BV(digitalPinToPCMSKbit(_receivePin));
-
     tunedDelay(_tx_delay); // if we were low this establishes the end
   }
 
@@ -374,9 +363,10 @@ void SoftwareSerial::begin(long speed)
   #endif
 
   // Only setup rx when we have a valid PCINT for this pin
-  if (digitalPinToPCICR((int8_t)_receivePin)) {
-    // Timings counted from gcc 7.3.0 output. This works up to 115200 on
-    // 16Mhz and 57600 on 8Mhz.
+  if (attachRx()) {
+    // Timings counted from gcc 7.3.0 output, with a vector of its own.
+    // This works up to 115200 on 16Mhz and 57600 on 8Mhz, the hook
+    // leaves little margin at those rates.
     // (the result of gcc 5.4.0 and 4.9.2 is a bit different but almost same)
     //
     // When the start bit occurs, there are 3 or 4 cycles before the
@@ -389,7 +379,10 @@ void SoftwareSerial::begin(long speed)
     // We want to have a total delay of 1.5 bit time. Inside the loop,
     // we already wait for 1 bit time - 13 cycles, so here we wait for
     // 0.5 bit time - (44 + 14 - 13) cycles.
-    _rx_delay_centering = subtract_cap(bit_delay / 2, (4 + 4 + 44 + 14 - 13) / 4);
+    // The core's vector calls recv() through its hook, which comes on
+    // top of that, PCINT_HOOK_CYCLES whatever the bit of the pin.
+    _rx_delay_centering = subtract_cap(bit_delay / 2,
+      (4 + 4 + PCINT_HOOK_CYCLES + 44 + 14 - 13) / 4);
 
     // There are 13 cycles in each loop iteration (excluding the delay)
     _rx_delay_intrabit = subtract_cap(bit_delay, 13 / 4);
@@ -403,16 +396,6 @@ void SoftwareSerial::begin(long speed)
     // reliably
     _rx_delay_stopbit = subtract_cap(bit_delay * 3 / 4, (28 + 6) / 4);
 
-
-    // Enable the PCINT for the entire port here, but never disable it
-    // (others might also need it, so we disable the interrupt by using
-    // the per-pin PCMSK register).
-    *digitalPinToPCICR((int8_t)_receivePin) |= _BV(digitalPinToPCICRbit(_receivePin));
-    // Precalculate the pcint mask register and value, so setRxIntMask
-    // can be used inside the ISR without costing too much time.
-    _pcint_maskreg = digitalPinToPCMSK(_receivePin);
-    _pcint_maskvalue = _BV(digitalPinToPCMSKbit(_receivePin));
-
     tunedDelay(_tx_delay); // if we were low this establishes the end
   }
 
@@ -424,14 +407,36 @@ void SoftwareSerial::begin(long speed)
   listen();
 }
 
+// interrupts are off
 void SoftwareSerial::setRxIntMsk(bool enable)
 {
     if (enable)
-      *_pcint_maskreg |= _pcint_maskvalue;
+      __pcintUnmask(_pcint_group, _pcint_maskreg, _receivePortRegister, _pcint_maskvalue);
     else
       *_pcint_maskreg &= ~_pcint_maskvalue;
 }
 
+// Hooks the receive pin's port in the core, masked until listen().
+bool SoftwareSerial::attachRx()
+{
+  uint8_t oldSREG = SREG;
+  bool ok;
+
+  cli();
+  ok = pinChangeInterruptHook(_receivePin, pcint_recv);
+  if (ok) {
+    // Precalculate the pcint mask register and value, so setRxIntMask
+    // can be used inside the ISR without costing too much time.
+    _pcint_maskreg = digitalPinToPCMSK(_receivePin);
+    _pcint_maskvalue = _BV(digitalPinToPCMSKbit(_receivePin));
+    _pcint_group = digitalPinToPCICRbit(_receivePin);
+    setRxIntMsk(false);
+  }
+  SREG = oldSREG;
+
+  return ok;
+}
+
 void SoftwareSerial::end()
 {
   stopListening();
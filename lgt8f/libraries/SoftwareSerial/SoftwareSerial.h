@@ -58,6 +58,7 @@ private:
   volatile uint8_t *_transmitPortRegister;
   volatile uint8_t *_pcint_maskreg;
   uint8_t _pcint_maskvalue;
+  uint8_t _pcint_group;
 
   // Expressed as 4-cycle delays (must never be 0!)
   uint16_t _rx_delay_centering;
@@ -80,6 +81,7 @@ private:
   void setTX(uint8_t transmitPin);
   void setRX(uint8_t receivePin);
   inline void setRxIntMsk(bool enable) __attribute__((__always_inline__));
+  bool attachRx();
 
   // Return num - sub, or 1 if the result would be < 1
   static uint16_t subtract_cap(uint16_t num, uint16_t sub);
@@ -502,6 +502,7 @@ bool twi_manageTimeoutFlag(bool clear_flag){
 
 ISR(TWI_vect)
 {
+  PROFILE_CORE(PROFILE_ISR_TWI);
   switch(TW_STATUS){
     // All Master
     case TW_START:     // sent start condition
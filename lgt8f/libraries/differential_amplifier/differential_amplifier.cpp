@@ -51,9 +51,11 @@
 #define DIFS_MXER (0UL << (1))
 #define DIFS_DIFFAMP bit(DIFS)
 
-int analogDiffRead(uint8_t negativePin, uint8_t positivePin, uint8_t gain) {
+// DAPCR value (without DAPEN and gain) for a pin pair, the pin that has
+// to be routed through the ADC multiplexer is returned in muxedPin
+static int diffSelect(uint8_t negativePin, uint8_t positivePin, uint8_t *muxedPin) {
   uint8_t inverting;
-  uint8_t muxedPin = A0;
+  *muxedPin = A0;
   switch (negativePin) {
     case A2:
       inverting = INVERTING_ADC2;
@@ -71,7 +73,7 @@ int analogDiffRead(uint8_t negativePin, uint8_t positivePin, uint8_t gain) {
 #endif
     default:
       inverting = INVERTING_MXER;
-      muxedPin = negativePin;
+      *muxedPin = negativePin;
   }
   uint8_t noninverting;
   switch (positivePin) {
@@ -83,15 +85,24 @@ int analogDiffRead(uint8_t negativePin, uint8_t positivePin, uint8_t gain) {
       break;
     default:
       noninverting = NONINVERTING_MXER;
-      muxedPin = positivePin;
+      *muxedPin = positivePin;
   }
   if ( (negativePin == positivePin) || ((inverting == INVERTING_MXER) && (noninverting == NONINVERTING_MXER)) ) {
     // combination not allowed
     return -1;
   }
+  return inverting | noninverting;
+}
+
+int analogDiffRead(uint8_t negativePin, uint8_t positivePin, uint8_t gain) {
+  uint8_t muxedPin;
+  int sel = diffSelect(negativePin, positivePin, &muxedPin);
+  if (sel < 0) {
+    return -1;
+  }
   // enable |   gain  |    inverting     | non-inverting
   // DAPEN  | GA1 GA0 | DNS2  DNS1  DNS0 | DPS1 DPS0
-  DAPCR = bit(DAPEN) | gain | inverting | noninverting;  // get right side
+  DAPCR = bit(DAPEN) | gain | sel;  // get right side
   ADCSRC |= DIFS_DIFFAMP;  // set Diff. Amp. as source for the ADC
   // Note: analogRead() will configure the muxer even if the multiplexer is not
   // used by neither the inverting nor the noninverting pin, but that's fine
@@ -101,3 +112,157 @@ int analogDiffRead(uint8_t negativePin, uint8_t positivePin, uint8_t gain) {
   ADCSRC &= ~DIFS_DIFFAMP;  // set back the Muxer as source for the ADC
   return res;
 }
+
+/** Calibration **/
+
+static const uint8_t gainFactor[4] = { 1, 8, 16, 32 };
+// shift from a gain to the GAIN_32 scale
+static const uint8_t gainShift[4] = { 5, 2, 1, 0 };
+
+DiffAmpCalibration diffAmpCalibration = {
+  DIFFAMP_CAL_MAGIC,
+  { 0, 0, 0, 0 },
+  { 32768, 32768, 32768, 32768 }
+};
+
+// sum of 256 conversions, i.e. the average in 1/256 LSB
+static uint32_t diffSum(uint8_t dapcr, uint8_t muxedPin) {
+  uint32_t sum = 0;
+  DAPCR = bit(DAPEN) | dapcr;
+  ADCSRC |= DIFS_DIFFAMP;
+  __analogRead(muxedPin);  // let the amplifier settle
+  for (uint16_t i = 0; i < 256; i++) {
+    sum += __analogRead(muxedPin);
+  }
+  DAPCR &= ~bit(DAPEN);
+  ADCSRC &= ~DIFS_DIFFAMP;
+  return sum;
+}
+
+bool diffAmpCalibrate(uint8_t negativePin, uint8_t positivePin) {
+  uint8_t muxedPin;
+  uint32_t zero[4], sig[4];
+  int sel = diffSelect(negativePin, positivePin, &muxedPin);
+  if (sel < 0) {
+    return false;
+  }
+
+  for (uint8_t g = 0; g < 4; g++) {
+    // both amplifier inputs on ground give the offset of each gain
+    zero[g] = diffSum((g << 5) | INVERTING_GRND | NONINVERTING_GRND, A0);
+    sig[g] = diffSum((g << 5) | sel, muxedPin);
+  }
+
+  // the input has to be well above the noise at GAIN_1
+  // and must not clip at GAIN_32
+  if (sig[0] < zero[0] + 16UL * 256 || sig[3] >= 4032UL * 256) {
+    return false;
+  }
+
+  // GAIN_1 is the reference, the other gains are corrected to it:
+  // k = g * (sig1 - zero1) / (sig - zero), in Q15
+  for (uint8_t g = 0; g < 4; g++) {
+    if (sig[g] < zero[g] + 256) {
+      return false;
+    }
+  }
+  for (uint8_t g = 0; g < 4; g++) {
+    diffAmpCalibration.offset[g] = (zero[g] + 128) >> 8;
+    uint32_t num = (gainFactor[g] * (sig[0] - zero[0])) >> 5;
+    uint32_t den = (sig[g] - zero[g]) >> 5;
+    uint32_t k = (num << 15) / den;
+    diffAmpCalibration.gain[g] = (k > 65535) ? 65535 : k;
+  }
+  diffAmpCalibration.gain[0] = 32768;
+  diffAmpCalibration.magic = DIFFAMP_CAL_MAGIC;
+  return true;
+}
+
+/** Streaming acquisition **/
+
+// clip level and the level below which the next gain would still not clip
+#define DIFF_CLIP 4032
+static const uint16_t gainUpLevel[3] = { 3072 / 8, 3072 / 2, 3072 / 2 };
+// samples below gainUpLevel before switching up, samples dropped after a switch
+#define DIFF_UP_COUNT 16
+#define DIFF_SETTLE 2
+
+static uint8_t diff_dapcr;
+static uint8_t diff_auto;
+static volatile uint8_t diff_gain;
+static uint8_t diff_settle;
+static uint8_t diff_low;
+
+// runs in the ADC interrupt: tags each sample with the gain it was taken at
+// and switches the gain when the signal clips or has room for more gain
+static uint16_t diffStreamHook(uint16_t val) {
+  uint8_t g = diff_gain;
+  if (diff_settle) {
+    diff_settle--;
+    return ANALOG_STREAM_SKIP;
+  }
+  if (diff_auto) {
+    uint8_t next = g;
+    if (val >= DIFF_CLIP) {
+      if (g > 0) next = g - 1;
+      diff_low = 0;
+    } else if (g < 3 && val < gainUpLevel[g]) {
+      if (++diff_low >= DIFF_UP_COUNT) next = g + 1;
+    } else {
+      diff_low = 0;
+    }
+    if (next != g) {
+      DAPCR = diff_dapcr | (next << 5);
+      diff_gain = next;
+      diff_settle = DIFF_SETTLE;
+      diff_low = 0;
+    }
+  }
+  return val | ((uint16_t)g << 12);
+}
+
+uint8_t diffStreamBegin(uint8_t negativePin, uint8_t positivePin, uint8_t gain,
+                        uint16_t *buf, uint8_t len, uint8_t trigger, bool autoGain) {
+  uint8_t muxedPin;
+  int sel = diffSelect(negativePin, positivePin, &muxedPin);
+  diffStreamEnd();
+  if (sel < 0) {
+    return 0;
+  }
+  diff_dapcr = bit(DAPEN) | sel;
+  diff_gain = (gain >> 5) & 0x03;
+  diff_auto = autoGain;
+  diff_settle = DIFF_SETTLE;
+  diff_low = 0;
+
+  DAPCR = diff_dapcr | (diff_gain << 5);
+  ADCSRC |= DIFS_DIFFAMP;
+  analogStreamHook(diffStreamHook);
+  if (!analogStreamBegin(muxedPin, buf, len, trigger)) {
+    diffStreamEnd();
+    return 0;
+  }
+  return 1;
+}
+
+void diffStreamEnd(void) {
+  analogStreamEnd();
+  analogStreamHook(0);
+  DAPCR &= ~bit(DAPEN);
+  ADCSRC &= ~DIFS_DIFFAMP;
+}
+
+uint8_t diffStreamGain(void) {
+  return diff_gain << 5;
+}
+
+bool diffStreamRead(long *value) {
+  int v = analogStreamRead();
+  if (v < 0) {
+    return false;
+  }
+  uint8_t g = v >> 12;
+  long d = (long)(v & 0x0fff) - diffAmpCalibration.offset[g];
+  *value = (d * diffAmpCalibration.gain[g]) >> (15 - gainShift[g]);
+  return true;
+}
@@ -17,6 +17,9 @@
   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+#ifndef DIFFERENTIAL_AMPLIFIER_H
+#define DIFFERENTIAL_AMPLIFIER_H
+
 #include <inttypes.h>
 
 #define GAIN_1 0b00 << 5
@@ -48,3 +51,61 @@ Reads the amplified difference between two pins.
 | A9  | ✓   | ✓   | ✓   | ✓   | ✓   | ✓   | ✓   | ✓   | ✓   |     |
 */
 int analogDiffRead(uint8_t negativePin, uint8_t positivePin, uint8_t gain);
+
+/*
+Calibration of the four gains, used by diffStreamRead().
+
+ offset: ADC counts read with both amplifier inputs on ground
+ gain:   correction to the nominal gain in Q15 (32768 = 1.0), GAIN_1 is
+         the reference the other gains are corrected to
+
+ Keep it in E2PROM with differential_amplifier_eeprom.h.
+*/
+#define DIFFAMP_CAL_MAGIC 0xda01
+
+struct DiffAmpCalibration {
+  uint16_t magic;
+  int16_t offset[4];
+  uint16_t gain[4];
+};
+
+extern DiffAmpCalibration diffAmpCalibration;
+
+/*
+Measures offset and gain of all four gains into diffAmpCalibration.
+
+ A steady differential voltage has to be applied between the pins, large
+ enough to read at least 16 counts at GAIN_1 but below full scale at
+ GAIN_32 (with the AVCC reference roughly 20mV to 150mV).
+
+ \returns false if the pin pair is not available or the input is out of range
+*/
+bool diffAmpCalibrate(uint8_t negativePin, uint8_t positivePin);
+
+/*
+Continuous acquisition through the differential amplifier.
+
+ The ADC runs from the core analogStream, see analogStreamBegin() for
+ buf, len and trigger. Every sample is tagged with the gain it was taken
+ at. With autoGain the gain is lowered as soon as a sample clips and
+ raised again after a run of samples that would fit the next gain; the
+ samples right after a switch are dropped while the amplifier settles.
+
+ \returns 0 if the pin pair is not available
+*/
+uint8_t diffStreamBegin(uint8_t negativePin, uint8_t positivePin, uint8_t gain,
+                        uint16_t *buf, uint8_t len, uint8_t trigger, bool autoGain);
+void diffStreamEnd(void);
+
+/*
+Next sample, offset and gain corrected and scaled to ADC counts at GAIN_32,
+independent of the gain it was taken at.
+
+ \returns false if no sample is ready
+*/
+bool diffStreamRead(long *value);
+
+// gain currently in use (GAIN_1 .. GAIN_32)
+uint8_t diffStreamGain(void);
+
+#endif
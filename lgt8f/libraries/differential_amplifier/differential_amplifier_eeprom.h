@@ -0,0 +1,30 @@
+/*
+  differential_amplifier_eeprom.h - keep the differential amplifier
+  calibration in E2PROM
+
+  Header only, so the E2PROM library is only pulled into sketches that
+  include this file.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+*/
+
+#include <EEPROM.h>
+#include "differential_amplifier.h"
+
+static inline void diffAmpSaveCalibration(int address) {
+  EEPROM.put(address, diffAmpCalibration);
+}
+
+// returns false and keeps the current values if nothing valid is stored
+static inline bool diffAmpLoadCalibration(int address) {
+  DiffAmpCalibration cal;
+  EEPROM.get(address, cal);
+  if (cal.magic != DIFFAMP_CAL_MAGIC) {
+    return false;
+  }
+  diffAmpCalibration = cal;
+  return true;
+}
@@ -0,0 +1,67 @@
+//============================================
+// Streaming shunt current measurement for LGT8F328P
+// Using the differential_amplifier library.
+// Connect the shunt between A2 (negative) and A0 (positive).
+// Samples are taken on every Timer0 overflow (~1ms) from the ADC
+// interrupt. The gain follows the signal automatically and every
+// sample is offset and gain corrected with the stored calibration.
+// Send 'c' with a steady ~50mV across the pins to calibrate, the
+// result is kept in E2PROM at address 0.
+//============================================
+#include "differential_amplifier.h"
+#include "differential_amplifier_eeprom.h"
+
+#define NEG_PIN A2
+#define POS_PIN A0
+#define CAL_ADDRESS 0
+
+uint16_t samples[32];
+const uint8_t gains[] = { 1, 8, 16, 32 };
+
+void start() {
+  diffStreamBegin(NEG_PIN, POS_PIN, GAIN_8, samples, sizeof(samples) / sizeof(samples[0]),
+                  ADC_TRIGGER_TIMER0_OVF, true);
+}
+
+void setup() {
+  Serial.begin(115200);
+  analogReference(DEFAULT);
+  if (!diffAmpLoadCalibration(CAL_ADDRESS)) {
+    Serial.println(F("not calibrated, using nominal gains"));
+  }
+  start();
+}
+
+long sum;
+uint16_t count;
+
+void loop() {
+  long value;
+  while (diffStreamRead(&value)) {
+    sum += value;
+    count++;
+  }
+
+  if (count >= 500) {
+    // ADC counts at GAIN_32: 5V / 4096 / 32 per count with AVCC reference
+    Serial.print(F("mean: "));
+    Serial.print(sum / count);
+    Serial.print(F(" gain: "));
+    Serial.print(gains[diffStreamGain() >> 5]);
+    Serial.print(F(" dropped: "));
+    Serial.println(analogStreamOverruns());
+    sum = 0;
+    count = 0;
+  }
+
+  if (Serial.read() == 'c') {
+    diffStreamEnd();
+    if (diffAmpCalibrate(NEG_PIN, POS_PIN)) {
+      diffAmpSaveCalibration(CAL_ADDRESS);
+      Serial.println(F("calibrated"));
+    } else {
+      Serial.println(F("calibration input out of range"));
+    }
+    start();
+  }
+}
@@ -0,0 +1,64 @@
+//============================================
+// LGT8FX8P ADC oversampling benchmark
+// For 12..16 bit resolution this measures the
+// time of one analogRead() and the noise of a
+// steady input, and prints the effective
+// number of bits (ENOB) for each setting.
+// Above 12 bit, 4^n conversions are summed and
+// decimated; analogReadOversampling(n) caps n
+// to bound the latency.
+// Connect A0 to a quiet, steady voltage.
+//============================================
+#define INPUT_PIN A0
+#define READS 64
+
+void measure(uint8_t res, uint8_t osbits) {
+  float mean = 0, m2 = 0;
+  uint32_t t0, t;
+
+  analogReadResolution(res);
+  analogReadOversampling(osbits);
+
+  t0 = micros();
+  for (uint8_t i = 1; i <= READS; i++) {
+    // Welford running variance
+    float x = (uint16_t)analogRead(INPUT_PIN);
+    float d = x - mean;
+    mean += d / i;
+    m2 += d * (x - mean);
+  }
+  t = (micros() - t0) / READS;
+
+  // noise below one step is quantization noise, 1/sqrt(12) LSB
+  float sigma = sqrt(m2 / (READS - 1));
+  if (sigma < 0.2887) sigma = 0.2887;
+  float enob = res - log(sigma * 3.4641) / log(2);
+
+  Serial.print(res);
+  Serial.print(F(" bit, "));
+  Serial.print(osbits);
+  Serial.print(F(" oversampled: "));
+  Serial.print(t);
+  Serial.print(F(" us/read, mean "));
+  Serial.print(mean, 1);
+  Serial.print(F(", sigma "));
+  Serial.print(sigma, 2);
+  Serial.print(F(" LSB, ENOB "));
+  Serial.println(enob, 2);
+}
+
+void setup() {
+  Serial.begin(115200);
+  analogReference(INTERNAL2V048);
+}
+
+void loop() {
+  for (uint8_t res = 12; res <= 16; res++) {
+    // shifted only (old behaviour) against true oversampling
+    measure(res, 0);
+    if (res > 12)
+      measure(res, res - 12);
+  }
+  Serial.println();
+  delay(5000);
+}
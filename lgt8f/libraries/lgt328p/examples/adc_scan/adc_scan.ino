@@ -0,0 +1,34 @@
+//============================================
+// LGT8FX8P ADC scan sequencer
+// A0..A5 plus the internal 1/5 VCC divider are
+// converted on every Timer0 overflow (~1ms).
+// loop() takes a consistent snapshot of all
+// channels without waiting for the ADC.
+//============================================
+const uint8_t pins[] = { A0, A1, A2, A3, A4, A5, V5D1 };
+#define CHANNELS sizeof(pins)
+
+uint16_t values[CHANNELS];
+uint16_t lastSeq;
+
+void setup() {
+  Serial.begin(115200);
+  analogReference(DEFAULT);
+  analogScanBegin(pins, CHANNELS, ADC_TRIGGER_TIMER0_OVF);
+}
+
+void loop() {
+  uint16_t seq = analogScanSnapshot(values);
+
+  // print once per 500 completed scans
+  if ((uint16_t)(seq - lastSeq) >= 500) {
+    lastSeq = seq;
+    Serial.print(seq);
+    for (uint8_t i = 0; i < CHANNELS; i++) {
+      Serial.print('\t');
+      Serial.print(values[i]);
+    }
+    // the last column is 1/5 VCC against the AVCC reference, ~819
+    Serial.println();
+  }
+}
@@ -0,0 +1,38 @@
+//============================================
+// LGT8FX8P interrupt driven ADC sampling
+// A0 is converted continuously in free running
+// mode, the ADC interrupt fills the ring buffer
+// and loop() only picks up finished samples.
+//============================================
+#define SAMPLES 64
+uint16_t samples[SAMPLES];
+
+uint32_t sum;
+uint16_t count;
+
+void setup() {
+  Serial.begin(115200);
+  analogReference(DEFAULT);
+
+  // or e.g. ADC_TRIGGER_TIMER0_OVF for one sample per ~1ms at 32MHz/16MHz
+  analogStreamBegin(A0, samples, SAMPLES, ADC_FREE_RUNNING);
+}
+
+void loop() {
+  int val;
+
+  // never blocks, returns -1 when no sample is ready
+  while ((val = analogStreamRead()) >= 0) {
+    sum += val;
+    count++;
+  }
+
+  if (count >= 10000) {
+    Serial.print(F("mean: "));
+    Serial.print(sum / count);
+    Serial.print(F(" dropped: "));
+    Serial.println(analogStreamOverruns());
+    sum = 0;
+    count = 0;
+  }
+}
@@ -0,0 +1,69 @@
+//============================================
+// LGT8FX8P DDS signal generator on DAC0 (D4)
+// Timer1 clocks 100k samples/s, each sample
+// steps a 32 bit phase through a sine table.
+// The frequency sweeps 100Hz..5kHz without
+// any phase step. Send 't' for a triangle,
+// 's' for a sawtooth played from a ring buffer
+// filled in loop(), anything else for sine.
+//============================================
+
+// 256 entry tables live in flash, top 8 bits of the phase index them
+const uint8_t triangle[256] PROGMEM = {
+#define T(i) (uint8_t)((i) < 128 ? (i) * 2 : 511 - (i) * 2)
+#define T8(i) T(i), T(i + 1), T(i + 2), T(i + 3), T(i + 4), T(i + 5), T(i + 6), T(i + 7)
+#define T64(i) T8(i), T8(i + 8), T8(i + 16), T8(i + 24), T8(i + 32), T8(i + 40), T8(i + 48), T8(i + 56)
+  T64(0), T64(64), T64(128), T64(192)
+};
+
+uint8_t ring[64];
+uint8_t saw;
+bool buffered;
+uint32_t hz = 100;
+uint32_t last;
+
+void setup() {
+  Serial.begin(115200);
+  analogReference(DEFAULT);
+
+  Serial.print(F("sample rate: "));
+  Serial.println(ddsBegin(DAC0, 100000, DDS_TIMER1));
+}
+
+void loop() {
+  if (Serial.available()) {
+    switch (Serial.read()) {
+      case 's':
+        buffered = ddsBuffer(ring, sizeof(ring));
+        break;
+      case 't':
+        ddsBuffer(0, 0);
+        buffered = false;
+        ddsWavetable(triangle);
+        break;
+      default:
+        ddsBuffer(0, 0);
+        buffered = false;
+        ddsWavetable(ddsSine);
+        break;
+    }
+  }
+
+  if (buffered) {
+    // keep the ring topped up, one step per sample is a 390Hz sawtooth
+    while (ddsAvailableForWrite())
+      ddsWrite(saw++);
+    if (millis() - last >= 1000) {
+      last = millis();
+      Serial.print(F("underruns: "));
+      Serial.println(ddsUnderruns());
+    }
+    return;
+  }
+
+  ddsFrequency(hz);
+  hz += 10;
+  if (hz > 5000)
+    hz = 100;
+  delay(2);
+}
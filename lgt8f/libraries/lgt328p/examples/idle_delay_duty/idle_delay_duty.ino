@@ -0,0 +1,48 @@
+//============================================
+// LGT8FX8P idle sleep and CPU duty cycle
+// delay() waits in IDLE sleep (delayIdle(1),
+// or the "Idle in delay()" board menu), and
+// loop() sleeps until the next scheduler task
+// is due. idleTime() returns the microseconds
+// spent asleep, every 5 seconds the share of
+// time the CPU was busy is printed.
+//============================================
+
+sched_task_t blink;
+
+void blinkTask() {
+  digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+uint32_t last;
+
+void setup() {
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  delayIdle(1);
+  schedulerAdd(&blink, blinkTask, 0, 500);
+
+  last = micros();
+  idleTime();
+}
+
+void loop() {
+  uint32_t now, idle, wait;
+
+  // nothing to do until the next task, sleep in steps of at most 1ms
+  // so Serial input and the like are still polled
+  wait = schedulerIdleTime();
+  if (wait)
+    idleSleep(1000);
+
+  now = micros();
+  if (now - last >= 5000000UL) {
+    idle = idleTime();
+    Serial.print(F("busy "));
+    Serial.print(100.0 * (now - last - idle) / (now - last));
+    Serial.println(F("%"));
+    Serial.flush();
+    last = now;
+  }
+}
@@ -0,0 +1,70 @@
+//============================================
+// External interrupt latency, INT0 bound at
+// compile time with ATTACH_INTERRUPT_FAST()
+// against INT1 through attachInterrupt().
+// D2 and D3 are driven as outputs, the rising
+// edge still triggers the interrupt. TCNT1 is
+// taken before the edge and first thing in
+// the handler, the difference is the entry
+// latency in clocks (31.25ns each at 32MHz).
+// D9/D10 lose pwm while cycles() runs.
+//============================================
+
+volatile uint16_t entered;
+
+static inline void onFast() {
+  entered = TCNT1;
+}
+
+void onSlow() {
+  entered = TCNT1;
+}
+
+ATTACH_INTERRUPT_FAST(0, onFast)
+
+uint16_t measure(uint8_t bit) {
+  uint16_t t;
+
+  PORTD &= ~_BV(bit);
+  noInterrupts();
+  t = TCNT1;
+  PORTD |= _BV(bit);
+  interrupts();
+  // the pending interrupt is taken here
+  return entered - t;
+}
+
+void report(const __FlashStringHelper *name, uint16_t t) {
+  Serial.print(name);
+  Serial.print(t);
+  Serial.println(F(" clocks"));
+}
+
+void setup() {
+  uint16_t fast = 0xffff, slow = 0xffff, t;
+  uint8_t i;
+
+  Serial.begin(115200);
+  cyclesBegin();
+
+  pinMode(2, OUTPUT);
+  pinMode(3, OUTPUT);
+  attachInterruptFast(0, RISING);
+  attachInterrupt(1, onSlow, RISING);
+
+  // best of several, Timer0 or Serial may get in between
+  for (i = 0; i < 16; i++) {
+    t = measure(2);
+    if (t < fast)
+      fast = t;
+    t = measure(3);
+    if (t < slow)
+      slow = t;
+  }
+
+  report(F("INT0 ATTACH_INTERRUPT_FAST(): "), fast);
+  report(F("INT1 attachInterrupt():       "), slow);
+}
+
+void loop() {
+}
@@ -0,0 +1,60 @@
+//============================================
+// Interrupt load of a running sketch
+// Build with Tools/Profiler enabled: the core
+// then counts and times its own interrupts.
+// Every second the share of the CPU each of
+// them took is printed, with its rate and
+// worst case. Sending 'b' gets the table as
+// the binary dump of profileDumpBinary()
+// instead, for a host side logger.
+//============================================
+
+#if !LGT_PROFILE
+#error "enable Tools/Profiler"
+#endif
+
+const uint8_t ids[] = {
+  PROFILE_ISR_MILLIS, PROFILE_ISR_SERIAL_RX, PROFILE_ISR_SERIAL_TX,
+  PROFILE_ISR_INT, PROFILE_ISR_PCINT, PROFILE_ISR_TWI, PROFILE_ISR_TONE
+};
+
+uint32_t started;
+
+void setup() {
+  Serial.begin(115200);
+  // some load: a tone on D3 and printing
+  tone(3, 2000);
+  started = cycles();
+}
+
+void loop() {
+  profile_entry_t e;
+  uint32_t span;
+  uint8_t i;
+
+  if (Serial.read() == 'b') {
+    profileDumpBinary(Serial);
+    return;
+  }
+
+  delay(1000);
+  span = cycles() - started;
+
+  for (i = 0; i < sizeof(ids); i++) {
+    if (!profileGet(ids[i], &e))
+      continue;
+    Serial.print(F("id "));
+    Serial.print(ids[i]);
+    Serial.print(F(": "));
+    Serial.print(100.0 * e.total / span, 3);
+    Serial.print(F("% cpu, "));
+    Serial.print(e.count);
+    Serial.print(F(" calls, worst "));
+    Serial.print(e.max);
+    Serial.println(F(" clocks"));
+  }
+  Serial.println();
+
+  profileReset();
+  started = cycles();
+}
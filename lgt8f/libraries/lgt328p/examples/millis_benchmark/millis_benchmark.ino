@@ -0,0 +1,98 @@
+//============================================
+// LGT8FX8P timekeeping backend benchmark
+// Build once with Tools/Timekeeping set to
+// Timer0 and once with Timer3 tickless, and
+// compare the share of CPU time taken by the
+// timekeeping interrupt and the cost of a
+// micros()/millis() call. Timer1 is used as
+// the reference clock.
+//============================================
+
+// about 20 clocks per pass, so the run stays well inside the
+// 65536 x 1024 clocks Timer1 counts before it wraps
+#define LOOPS 1500000UL
+
+// a fixed amount of work, timed in Timer1 ticks at clk/1024,
+// 0 if Timer1 wrapped during the run
+uint16_t work(bool irq) {
+  volatile uint32_t n;
+  uint16_t t;
+
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  if (!irq)
+    noInterrupts();
+  TCCR1B = _BV(CS12) | _BV(CS10);
+  for (n = 0; n < LOOPS; n++);
+  t = TCNT1;
+  interrupts();
+  if (TIFR1 & _BV(TOV1))
+    t = 0;
+
+  return t;
+}
+
+// average cycles of fn(), Timer1 at clk/1
+uint16_t callCost(unsigned long (*fn)(void)) {
+  volatile unsigned long sink;
+  uint16_t empty, full;
+  uint8_t i;
+
+  TCCR1B = 0;
+  TCNT1 = 0;
+  TCCR1B = _BV(CS10);
+  for (i = 0; i < 100; i++)
+    sink = i;
+  empty = TCNT1;
+
+  TCCR1B = 0;
+  TCNT1 = 0;
+  TCCR1B = _BV(CS10);
+  for (i = 0; i < 100; i++)
+    sink = fn();
+  full = TCNT1;
+
+  return (full - empty) / 100;
+}
+
+void setup() {
+  Serial.begin(115200);
+#if LGT_TIMER3_MILLIS
+  Serial.println(F("backend: Timer3 tickless"));
+#else
+  Serial.println(F("backend: Timer0 overflow"));
+#endif
+  delay(10);
+}
+
+void loop() {
+  uint16_t off = work(false);
+  uint16_t on = work(true);
+
+  if (off == 0 || on == 0) {
+    Serial.println(F("Timer1 wrapped, lower LOOPS"));
+    delay(2000);
+    return;
+  }
+
+  Serial.print(F("interrupt share: "));
+  Serial.print(on > off ? (on - off) * 1000000UL / on : 0);
+  Serial.println(F(" ppm"));
+
+  Serial.print(F("micros(): "));
+  Serial.print(callCost(micros));
+  Serial.print(F(" cycles, millis(): "));
+  Serial.print(callCost(millis));
+  Serial.println(F(" cycles"));
+
+  // resolution: the smallest step micros() makes
+  unsigned long a = micros(), b;
+  while ((b = micros()) == a);
+  Serial.print(F("micros() step: "));
+  Serial.print(b - a);
+  Serial.println(F(" us"));
+
+  delay(2000);
+}
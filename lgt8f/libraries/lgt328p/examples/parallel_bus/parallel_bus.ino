@@ -0,0 +1,41 @@
+//============================================
+// 8 bit parallel bus with a write strobe
+// D2..D9 carry the data (PD2..PD7 and PB0..
+// PB1, one shift per port), D10 is an active
+// low WR strobe as on 8080 style displays.
+// A PROGMEM table is sent as a burst, then
+// a counter is written word by word and the
+// words per second are printed.
+//============================================
+
+const uint8_t busPins[8] = { 2, 3, 4, 5, 6, 7, 8, 9 };
+const uint8_t table[] PROGMEM = {
+  0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0xff
+};
+
+parallel_bus_t bus;
+
+void setup() {
+  uint32_t t;
+  uint16_t i;
+
+  Serial.begin(115200);
+
+  if (!parallelBusBegin(&bus, busPins, 8, 10, PARALLEL_STROBE_LOW)) {
+    Serial.println(F("bad pins"));
+    return;
+  }
+
+  parallelBusWriteBuffer_P(&bus, table, sizeof(table));
+
+  t = micros();
+  for (i = 0; i < 10000; i++)
+    parallelBusWrite(&bus, i);
+  t = micros() - t;
+
+  Serial.print(10000000UL / t);
+  Serial.println(F(" kwords/s"));
+}
+
+void loop() {
+}
@@ -0,0 +1,80 @@
+//============================================
+// Pin change dispatch cost per edge
+// A0..A5 (PC0..PC5) are outputs, each with
+// its own callback. A rising edge is made
+// on one pin with TCNT1 taken just before;
+// the callback takes TCNT1 on entry, the
+// main code again when the interrupt has
+// returned. A0 is the first bit scanned,
+// A5 the last. Last A0 goes through a hook
+// instead, the path SoftwareSerial takes.
+// Clocks are 31.25ns at 32MHz.
+// D9/D10 lose pwm while cycles() runs.
+//============================================
+
+volatile uint16_t entered;
+
+void onEdge(uint8_t level) {
+  entered = TCNT1;
+  (void)level;
+}
+
+void onHook() {
+  entered = TCNT1;
+}
+
+void measure(uint8_t pin) {
+  volatile uint8_t *port = portOutputRegister(digitalPinToPort(pin));
+  uint8_t mask = digitalPinToBitMask(pin);
+  uint16_t callback = 0xffff, total = 0xffff, t, done;
+  uint8_t i;
+
+  // best of several, Timer0 or Serial may get in between
+  for (i = 0; i < 16; i++) {
+    *port &= ~mask;
+    noInterrupts();
+    t = TCNT1;
+    *port |= mask;
+    interrupts();
+    // the pending interrupt is taken here
+    done = TCNT1;
+    if (entered - t < callback)
+      callback = entered - t;
+    if (done - t < total)
+      total = done - t;
+  }
+
+  Serial.print(F("A"));
+  Serial.print(pin - A0);
+  Serial.print(F(": to callback "));
+  Serial.print(callback);
+  Serial.print(F(", whole edge "));
+  Serial.print(total);
+  Serial.println(F(" clocks"));
+}
+
+void setup() {
+  uint8_t pin;
+
+  Serial.begin(115200);
+  cyclesBegin();
+
+  for (pin = A0; pin <= A5; pin++) {
+    digitalWrite(pin, LOW);
+    pinMode(pin, OUTPUT);
+    attachPinChangeInterrupt(pin, onEdge, RISING);
+  }
+
+  measure(A0);
+  measure(A5);
+
+  // the hook sets its PCMSKn bit itself
+  detachPinChangeInterrupt(A0);
+  pinChangeInterruptHook(A0, onHook);
+  *digitalPinToPCMSK(A0) |= _BV(digitalPinToPCMSKbit(A0));
+  Serial.print(F("hook, "));
+  measure(A0);
+}
+
+void loop() {
+}
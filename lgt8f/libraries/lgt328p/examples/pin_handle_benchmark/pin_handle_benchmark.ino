@@ -0,0 +1,69 @@
+//============================================
+// Runtime pin numbers: digitalWrite() against
+// pinResolve()/pinWrite()
+// The pins come from a table, as in table
+// driven firmware, so nothing is known at
+// compile time. Cycles per call are counted
+// with cycles(); build once with the "Digital
+// pin cache" menu on and once with it off to
+// compare both digitalWrite() variants.
+// D9/D10 lose pwm while cycles() runs.
+//============================================
+
+const uint8_t pins[] = { 2, 3, 4, 7, 8, 12, LED_BUILTIN };
+#define NPINS sizeof(pins)
+
+pinHandle handles[NPINS];
+
+void setup() {
+  uint32_t t, overhead;
+  uint32_t write = 0, read = 0, hwrite = 0, hread = 0;
+  volatile uint8_t r;
+  uint8_t i;
+
+  Serial.begin(115200);
+  cyclesBegin();
+
+  for (i = 0; i < NPINS; i++) {
+    pinMode(pins[i], OUTPUT);
+    handles[i] = pinResolve(pins[i]);
+  }
+
+  t = cycles();
+  overhead = cycles() - t;
+
+  for (i = 0; i < NPINS; i++) {
+    t = cycles();
+    digitalWrite(pins[i], HIGH);
+    write += cycles() - t - overhead;
+
+    t = cycles();
+    r = digitalRead(pins[i]);
+    read += cycles() - t - overhead;
+
+    t = cycles();
+    pinWrite(handles[i], LOW);
+    hwrite += cycles() - t - overhead;
+
+    t = cycles();
+    r = pinRead(handles[i]);
+    hread += cycles() - t - overhead;
+  }
+  (void)r;
+
+  Serial.print(F("digitalWrite: "));
+  Serial.print(write / NPINS);
+  Serial.println(F(" cycles"));
+  Serial.print(F("digitalRead:  "));
+  Serial.print(read / NPINS);
+  Serial.println(F(" cycles"));
+  Serial.print(F("pinWrite:     "));
+  Serial.print(hwrite / NPINS);
+  Serial.println(F(" cycles"));
+  Serial.print(F("pinRead:      "));
+  Serial.print(hread / NPINS);
+  Serial.println(F(" cycles"));
+}
+
+void loop() {
+}
@@ -0,0 +1,76 @@
+//============================================
+// Compile time pins, Pin<N> and PinGroup
+// Counts the cycles of each pin operation
+// with cycles() next to digitalWrite(), on
+// any variant. Pin<N> write/toggle/read are
+// single instructions (1-2 cycles), a group
+// write is one read-modify-write per port.
+// D9/D10 lose pwm while cycles() runs.
+//============================================
+
+typedef Pin<LED_BUILTIN> led;
+typedef Pin<2> button;
+// D5..D8: three pins on port D and one on port B
+typedef PinGroup<5, 6, 7, 8> nibble;
+
+uint32_t overhead;
+
+void report(const __FlashStringHelper *name, uint32_t t) {
+  Serial.print(name);
+  Serial.print(F(": "));
+  Serial.print(t - overhead);
+  Serial.println(F(" cycles"));
+}
+
+void setup() {
+  uint32_t t;
+  uint8_t pin = LED_BUILTIN;
+  volatile uint8_t r;
+  volatile uint16_t w;
+
+  Serial.begin(115200);
+  cyclesBegin();
+
+  led::mode(OUTPUT);
+  button::mode(INPUT_PULLUP);
+  nibble::mode(OUTPUT);
+
+  t = cycles();
+  overhead = cycles() - t;
+
+  t = cycles();
+  led::high();
+  report(F("Pin<N>::high()"), cycles() - t);
+
+  t = cycles();
+  led::toggle();
+  report(F("Pin<N>::toggle()"), cycles() - t);
+
+  t = cycles();
+  r = button::read();
+  report(F("Pin<N>::read()"), cycles() - t);
+
+  t = cycles();
+  nibble::write(0x5);
+  report(F("PinGroup<4 pins>::write()"), cycles() - t);
+
+  t = cycles();
+  w = nibble::read();
+  report(F("PinGroup<4 pins>::read()"), cycles() - t);
+
+  t = cycles();
+  digitalWrite(LED_BUILTIN, HIGH);
+  report(F("digitalWrite(constant)"), cycles() - t);
+
+  t = cycles();
+  digitalWrite(pin, LOW);
+  report(F("digitalWrite(variable)"), cycles() - t);
+
+  (void)r;
+  (void)w;
+}
+
+void loop() {
+  // square wave on LED_BUILTIN at the toggle speed
+  led::toggle();
+}
@@ -0,0 +1,49 @@
+//============================================
+// LGT8FX8P cycle counter and scoped profiler
+// cycles() counts CPU clocks on Timer1, each
+// PROFILE_SCOPE() adds the time spent in its
+// block to a table that is dumped over Serial.
+// With Tools/Profiler enabled the core also
+// times digitalWrite, analogRead, Serial.write,
+// printNumber and its interrupts.
+//============================================
+
+#define PROF_SQRT   (PROFILE_USER + 0)
+#define PROF_LOOP   (PROFILE_USER + 1)
+
+volatile float result;
+
+float slowSqrt(float x) {
+  PROFILE_SCOPE(PROF_SQRT);
+  return sqrt(x);
+}
+
+void setup() {
+  Serial.begin(115200);
+#if !LGT_PROFILE
+  // init() only starts the counter when the core is instrumented
+  cyclesBegin();
+#endif
+
+  uint32_t t = cycles();
+  delayMicroseconds(100);
+  Serial.print(F("100us = "));
+  Serial.print(cycles() - t);
+  Serial.println(F(" cycles"));
+}
+
+void loop() {
+  PROFILE_SCOPE(PROF_LOOP);
+  static uint16_t n;
+
+  result = slowSqrt(n);
+  digitalWrite(LED_BUILTIN, n & 1);
+  analogRead(A0);
+
+  if (++n == 1000) {
+    n = 0;
+    profileDump(Serial);
+    profileReset();
+    delay(2000);
+  }
+}
@@ -0,0 +1,45 @@
+//============================================
+// Pulse widths by input capture on ICP1 (D8)
+// Every edge is timestamped by Timer1 in
+// hardware, loop() only reads the ring
+// buffer and prints the time each level was
+// held, in us with full clock resolution.
+// Connect e.g. an IR receiver or an RC PPM
+// signal to D8. D9/D10 have no pwm meanwhile.
+//============================================
+
+capture_edge_t edges[32];
+capture_edge_t last;
+uint8_t haveLast;
+
+void setup() {
+  Serial.begin(115200);
+
+  pulseCaptureBegin(CAPTURE_TIMER1, edges, 32, CHANGE | CAPTURE_NOISE_CANCEL);
+}
+
+void loop() {
+  capture_edge_t e;
+  uint32_t clocks, ns;
+  uint16_t lost;
+
+  while (pulseCaptureRead(CAPTURE_TIMER1, &e)) {
+    if (haveLast) {
+      clocks = e.time - last.time;
+      ns = clocks * (1000000000.0 / pulseCaptureClock(CAPTURE_TIMER1));
+      Serial.print(last.level ? F("high ") : F("low  "));
+      Serial.print(ns / 1000);
+      Serial.print('.');
+      Serial.print((ns % 1000) / 100);
+      Serial.println(F(" us"));
+    }
+    last = e;
+    haveLast = 1;
+  }
+
+  lost = pulseCaptureOverruns(CAPTURE_TIMER1);
+  if (lost) {
+    Serial.print(lost);
+    Serial.println(F(" edges lost"));
+  }
+}
@@ -0,0 +1,34 @@
+//============================================
+// LGT8FX8P 64MHz timer clock for fast PWM
+// Timer1 is switched to the doubled internal
+// oscillator (also selectable at start-up in
+// the "Fast timer clock" menu), a 250kHz PWM
+// on D9 then still has 8 bit of resolution.
+// millis() on Timer0 keeps its pace.
+//============================================
+
+void setup() {
+  Serial.begin(115200);
+
+  Serial.print(F("at "));
+  Serial.print(timerClock(1));
+  Serial.print(F("Hz: "));
+  Serial.print(analogWriteFrequency(9, 250000));
+  Serial.println(F(" bit"));
+
+  timerFastClock(TIMER_FAST_CLOCK1);
+
+  Serial.print(F("at "));
+  Serial.print(timerClock(1));
+  Serial.print(F("Hz: "));
+  // periods are counted in timer clocks, set the frequency again
+  Serial.print(analogWriteFrequency(9, 250000));
+  Serial.println(F(" bit"));
+
+  analogWriteHR(9, 0x8000);
+}
+
+void loop() {
+  Serial.println(millis());
+  delay(1000);
+}
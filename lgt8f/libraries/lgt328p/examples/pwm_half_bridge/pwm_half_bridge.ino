@@ -0,0 +1,39 @@
+//============================================
+// LGT8FX8P half-bridge drive on Timer1
+// D9 (OC1A) drives the high side, D10 (OC1B)
+// the low side with the complement, both with
+// 250ns dead time inserted by the timer.
+// A falling edge on D2 (INT0) turns both off,
+// send 'r' to resume after the fault cleared.
+//============================================
+
+void setup() {
+  Serial.begin(115200);
+  pinMode(2, INPUT_PULLUP);
+
+  // 40kHz leaves 800 steps (9 bit) at 32MHz
+  uint8_t bits = halfBridgeBegin(9, 40000, 250, HALF_BRIDGE_FAULT_INT0);
+  Serial.print(F("resolution: "));
+  Serial.println(bits);
+
+  halfBridgeWrite(9, 0x8000);
+}
+
+void loop() {
+  static bool reported;
+
+  if (halfBridgeFault(9)) {
+    if (!reported)
+      Serial.println(F("fault, outputs off"));
+    reported = true;
+  }
+
+  if (Serial.read() == 'r') {
+    halfBridgeResume(9);
+    reported = false;
+  }
+
+  // the duty follows a pot on A0, no cpu work per pwm cycle
+  halfBridgeWrite(9, (uint16_t)analogRead(A0) << 6);
+  delay(10);
+}
@@ -0,0 +1,36 @@
+//============================================
+// LGT8FX8P 16 bit PWM on Timer1 (D9/D10)
+// Timer1 runs fast PWM with ICR1 as top, the
+// frequency sets how many of the 16 duty bits
+// are left: 32MHz / 20kHz = 1600 steps, 10 bit.
+// D9 fades an LED flicker free, D10 shows 25%.
+//============================================
+
+void setup() {
+  Serial.begin(115200);
+
+  // above the audible range for motor drives
+  uint8_t bits = analogWriteFrequency(9, 20000);
+  Serial.print(F("resolution at 20kHz: "));
+  Serial.print(bits);
+  Serial.println(F(" bit"));
+
+  // 500Hz leaves 64000 steps, just short of 16 bit
+  bits = analogWriteFrequency(9, 500);
+  Serial.print(F("resolution at 500Hz: "));
+  Serial.print(bits);
+  Serial.println(F(" bit"));
+
+  analogWriteHR(10, 0x4000);
+}
+
+void loop() {
+  static uint16_t duty = 1;
+
+  // a gamma-ish ramp, needs the low duty steps 8 bit pwm does not have
+  analogWriteHR(9, duty);
+  duty += (duty >> 6) + 1;
+  if (duty < 0x40)
+    delay(20);
+  delay(2);
+}
@@ -0,0 +1,52 @@
+//============================================
+// LGT8FX8P cooperative task scheduler
+// The LED blinks from a periodic task, a
+// one-shot task fires once after 5 seconds,
+// and both keep running while loop() is stuck
+// in delay(). Every 10 seconds the statistics
+// of the tasks are printed.
+//============================================
+
+sched_task_t blink, once, report;
+
+void blinkTask() {
+  digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+void onceTask() {
+  Serial.println(F("one-shot fired"));
+}
+
+void printTask(const __FlashStringHelper *name, sched_task_t *t) {
+  Serial.print(name);
+  Serial.print(F(": runs "));
+  Serial.print(t->runs);
+  Serial.print(F(" late "));
+  Serial.print(t->late);
+  Serial.print(F(" (max "));
+  Serial.print(t->max_late);
+  Serial.print(F("ms) overruns "));
+  Serial.print(t->overruns);
+  Serial.print(F(" max run "));
+  Serial.print(t->max_run);
+  Serial.println(F("us"));
+}
+
+void reportTask() {
+  printTask(F("blink"), &blink);
+  printTask(F("report"), &report);
+}
+
+void setup() {
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  schedulerAdd(&blink, blinkTask, 0, 250);
+  schedulerAdd(&once, onceTask, 5000, 0);
+  schedulerAdd(&report, reportTask, 10000, 10000);
+}
+
+void loop() {
+  // the tasks are serviced from yield() inside delay()
+  delay(1000);
+}
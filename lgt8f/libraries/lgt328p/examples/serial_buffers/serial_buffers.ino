@@ -0,0 +1,55 @@
+//============================================
+// Serial buffers from the sketch
+// With D2 low the board is a serial bridge
+// and Serial gets 768/256 byte rings; with
+// D2 high it logs a sensor with the default
+// buffers and the same RAM is a sample
+// buffer instead. The big rings and the
+// samples share one block of memory; the
+// default rings (64 rx, 16 tx) stay
+// allocated either way.
+//============================================
+
+union {
+  struct {
+    uint8_t rx[768];
+    uint8_t tx[256];
+  } bridge;
+  uint16_t samples[512];
+} ram;
+
+bool bridge;
+
+void setup() {
+  pinMode(2, INPUT_PULLUP);
+  bridge = digitalRead(2) == LOW;
+
+  if (bridge)
+    Serial.begin(500000, SERIAL_8N1, ram.bridge.rx, sizeof(ram.bridge.rx),
+      ram.bridge.tx, sizeof(ram.bridge.tx));
+  else
+    Serial.begin(115200);
+}
+
+void loop() {
+  uint8_t buf[64];
+  uint16_t i;
+  size_t n;
+
+  if (bridge) {
+    // echo whatever came in, in whole blocks
+    n = Serial.available();
+    if (n > sizeof(buf))
+      n = sizeof(buf);
+    if (n) {
+      n = Serial.readBytes(buf, n);
+      Serial.write(buf, n);
+    }
+    return;
+  }
+
+  for (i = 0; i < sizeof(ram.samples) / sizeof(ram.samples[0]); i++)
+    ram.samples[i] = analogRead(A0);
+  Serial.println(ram.samples[0]);
+  delay(1000);
+}
@@ -0,0 +1,86 @@
+//============================================
+// Serial throughput and CPU share at 1Mbaud
+// (32MHz, set the terminal to 1000000).
+// Sends the same block byte by byte and with
+// one write(buf, len) call, reports bytes/s
+// of each, and then the share of the CPU
+// that keeping the transmitter busy takes:
+// a counting loop runs while the ring is
+// topped up, against the same loop idle.
+// D9/D10 lose pwm while cycles() runs.
+//============================================
+
+#define BLOCK 32
+#define TOTAL 4096
+
+uint8_t block[BLOCK];
+
+uint32_t rate(uint32_t clocks) {
+  return (uint64_t)TOTAL * F_CPU / clocks;
+}
+
+uint32_t sendBytes() {
+  uint32_t t = cycles();
+  uint16_t i, j;
+
+  for (i = 0; i < TOTAL / BLOCK; i++)
+    for (j = 0; j < BLOCK; j++)
+      Serial.write(block[j]);
+  Serial.flush();
+  return cycles() - t;
+}
+
+uint32_t sendBlocks() {
+  uint32_t t = cycles();
+  uint16_t i;
+
+  for (i = 0; i < TOTAL / BLOCK; i++)
+    Serial.write(block, BLOCK);
+  Serial.flush();
+  return cycles() - t;
+}
+
+// loop passes in a fixed time, optionally keeping the ring filled
+uint32_t spin(bool send) {
+  uint32_t t = cycles(), n = 0;
+
+  while (cycles() - t < F_CPU / 10) {
+    if (send && Serial.availableForWrite() >= BLOCK)
+      Serial.write(block, BLOCK);
+    n++;
+  }
+  Serial.flush();
+  return n;
+}
+
+void setup() {
+  uint32_t bytes, blocks, idle, busy;
+  uint8_t i;
+
+  for (i = 0; i < BLOCK - 2; i++)
+    block[i] = 'a' + i % 26;
+  block[BLOCK - 2] = '\r';
+  block[BLOCK - 1] = '\n';
+
+  Serial.begin(1000000);
+  cyclesBegin();
+
+  bytes = sendBytes();
+  blocks = sendBlocks();
+  idle = spin(false);
+  busy = spin(true);
+
+  Serial.println();
+  Serial.print(F("write(c):        "));
+  Serial.print(rate(bytes));
+  Serial.println(F(" bytes/s"));
+  Serial.print(F("write(buf, len): "));
+  Serial.print(rate(blocks));
+  Serial.println(F(" bytes/s"));
+  Serial.print(F("CPU share:       "));
+  Serial.print(100.0 * (idle - busy) / idle, 1);
+  Serial.println(F(" %"));
+}
+
+void loop() {
+}
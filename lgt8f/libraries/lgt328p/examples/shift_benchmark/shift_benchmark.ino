@@ -0,0 +1,48 @@
+//============================================
+// shiftOut throughput, hardware and bit-bang
+// shiftOutBuffer() on MOSI/SCK (D11/D13) runs
+// on the SPI unit, on D5/D6 it is bit-banged.
+// The SPI clock is limited by shiftClock(),
+// which paces the bit-bang too, F_CPU/2
+// leaves it unpaced.
+// the kbit/s of each case are printed; run at
+// 32MHz for the numbers to compare.
+//============================================
+
+uint8_t buf[256];
+
+void measure(const __FlashStringHelper *name, uint8_t data, uint8_t clock) {
+  uint32_t t;
+
+  pinMode(data, OUTPUT);
+  pinMode(clock, OUTPUT);
+
+  t = micros();
+  shiftOutBuffer(data, clock, MSBFIRST, buf, sizeof(buf));
+  t = micros() - t;
+
+  Serial.print(name);
+  Serial.print(F(": "));
+  Serial.print(sizeof(buf) * 8000UL / t);
+  Serial.println(F(" kbit/s"));
+}
+
+void setup() {
+  uint16_t i;
+
+  Serial.begin(115200);
+  for (i = 0; i < sizeof(buf); i++)
+    buf[i] = i;
+
+  // SS as output keeps the SPI unit in master mode
+  pinMode(SS, OUTPUT);
+
+  shiftClock(4000000UL);
+  measure(F("SPI 4MHz"), MOSI, SCK);
+  shiftClock(F_CPU / 2);
+  measure(F("SPI F_CPU/2"), MOSI, SCK);
+  measure(F("bit-bang D5/D6"), 5, 6);
+}
+
+void loop() {
+}
@@ -0,0 +1,79 @@
+//============================================
+// LGT8FX8P uDSC benchmark
+// Compares libgcc arithmetic against the uDSC
+// computation accelerator (udsc.h) and checks
+// that both give the same results.
+// Timer1 runs at clk/1 and counts CPU cycles.
+// Select "uDSC arithmetic: Enabled" in the
+// tools menu to route print()/map()/micros()/
+// pulseIn() through the uDSC as well.
+//============================================
+#define RUNS 64
+
+volatile uint32_t va = 0x12345678UL;
+volatile uint16_t vb = 10, vx = 1023, vy = 255;
+volatile uint32_t sink;
+
+static inline void startCount() {
+  TCNT1 = 0;
+}
+
+static inline uint16_t stopCount() {
+  return TCNT1;
+}
+
+void report(const char *name, uint16_t soft, uint16_t hw) {
+  Serial.print(name);
+  Serial.print(F(": libgcc "));
+  Serial.print(soft / RUNS);
+  Serial.print(F(" cycles, uDSC "));
+  Serial.print(hw / RUNS);
+  Serial.println(F(" cycles"));
+}
+
+void setup() {
+  Serial.begin(115200);
+  udscBegin();
+
+  // Timer1 free running at clk/1, no PWM
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+  uint16_t soft, hw;
+  uint8_t i;
+
+  startCount();
+  for (i = 0; i < RUNS; i++) sink = (uint32_t)vx * vy;
+  soft = stopCount();
+  startCount();
+  for (i = 0; i < RUNS; i++) sink = udscMul16(vx, vy);
+  hw = stopCount();
+  report("16x16 mul", soft, hw);
+
+  startCount();
+  for (i = 0; i < RUNS; i++) sink = va / vb;
+  soft = stopCount();
+  startCount();
+  for (i = 0; i < RUNS; i++) sink = udscDiv32(va, vb);
+  hw = stopCount();
+  report("32/16 div", soft, hw);
+
+  startCount();
+  for (i = 0; i < RUNS; i++) sink = va * vb;
+  soft = stopCount();
+  startCount();
+  for (i = 0; i < RUNS; i++) sink = udscMul32x16(va, vb);
+  hw = stopCount();
+  report("32x16 mul", soft, hw);
+
+  // results must match the C operators
+  uint16_t rem;
+  uint32_t q = udscDivMod32(va, vb, &rem);
+  Serial.print(F("div check: "));
+  Serial.println((q == va / vb && rem == va % vb) ? F("ok") : F("FAIL"));
+  Serial.print(F("mul check: "));
+  Serial.println((udscMulS16(-1234, 567) == -1234L * 567) ? F("ok") : F("FAIL"));
+}
+
+void loop() {
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * This example shows how to sleep until an analog input leaves a window.     *
+ * ( LGT8Fx8P only )                                                           *
+ *                                                                             *
+ * analogMonitor() hands the threshold check to the ADC auto monitor. The ADC  *
+ * keeps converting A0 on its own and only raises its interrupt after 4        *
+ * consecutive results are below 1000 or above 3000 (12 bit scale). The ADC   *
+ * interrupt wakes the MCU from Idle, so the ADC has to stay ON in sleep.      *
+ *                                                                             *
+ * - Timer 0 is turned off, otherwise its interrupt wakes up every ms.         *
+ * - After an event the monitor stops, analogMonitorResume() restarts it.      *
+ *******************************************************************************/
+
+#include <lgt_LowPower.h>
+
+void setup()
+{
+    pinMode(LED_BUILTIN, OUTPUT);
+    Serial.begin(9600);
+    Serial.println("Started.");
+    Serial.flush();
+
+    analogReference(DEFAULT);
+    analogMonitor(A0, 1000, 3000, 4, NULL);
+}
+
+void loop() 
+{
+    LowPower.idle(SLEEP_FOREVER, ADC_ON, TIMER3_OFF, TIMER2_OFF, TIMER1_OFF, TIMER0_OFF, 
+                SPI_OFF, USART0_ON, TWI_OFF, PCIC_OFF, FLASHCTL_OFF);
+
+    uint8_t event = analogMonitorEvent();
+    if (event) {
+        digitalToggle(LED_BUILTIN);
+        Serial.println(event == ANALOG_MONITOR_HIGH ? F("A0 over 3000") : F("A0 under 1000"));
+        Serial.flush();
+
+        // here the level may still be outside the window, a real
+        // application would wait or widen the window before resuming
+        analogMonitorResume();
+    }
+}
@@ -218,6 +218,71 @@ static const uint8_t A10 = 25;
 
 #define digitalPinToInterrupt(p)  ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
 
+#ifdef __cplusplus
+// port and bit of each digital pin as a constant expression, for the
+// Pin<N> templates in fastio_pin.h. Has to follow digital_pin_to_port_PGM
+// and digital_pin_to_bit_mask_PGM below.
+#define _PIN_PB(bit)	(0x20 | (bit))
+#define _PIN_PC(bit)	(0x30 | (bit))
+#define _PIN_PD(bit)	(0x40 | (bit))
+#define _PIN_PE(bit)	(0x50 | (bit))
+#define _PIN_PF(bit)	(0x60 | (bit))
+
+constexpr uint8_t digital_pin_desc[] = {
+	_PIN_PD(0), /* 0 */
+	_PIN_PD(1),
+	_PIN_PD(2),
+	_PIN_PD(3),
+	_PIN_PD(4),
+	_PIN_PD(5),
+	_PIN_PD(6),
+	_PIN_PD(7),
+	_PIN_PB(0), /* 8 */
+	_PIN_PB(1),
+	_PIN_PB(2),
+	_PIN_PB(3),
+	_PIN_PB(4),
+	_PIN_PB(5),
+	_PIN_PC(0), /* 14 */
+	_PIN_PC(1),
+	_PIN_PC(2),
+	_PIN_PC(3),
+	_PIN_PC(4),
+	_PIN_PC(5),
+#if defined(__LGT8FX8E__) || defined(__LGT8FX8P__)
+	_PIN_PE(1), /* 20 */
+	_PIN_PE(3), /* 21 */
+#if defined(__LGT8FX8P48__)
+	_PIN_PB(6), /* 22 */
+	_PIN_PC(7), /* 23 */
+	_PIN_PF(0), /* 24 */
+	_PIN_PE(6), /* 25 */
+	_PIN_PE(7), /* 26 */
+	_PIN_PB(7), /* 27 */
+	_PIN_PC(6), /* 28 */
+	_PIN_PE(0), /* 29 */
+	_PIN_PE(2), /* 30 */
+	_PIN_PE(4), /* 31 */
+	_PIN_PE(5), /* 32 */
+	_PIN_PF(1), /* 33 */
+	_PIN_PF(2), /* 34 */
+	_PIN_PF(3), /* 35 */
+	_PIN_PF(4), /* 36 */
+	_PIN_PF(5), /* 37 */
+	_PIN_PF(6), /* 38 */
+	_PIN_PF(7), /* 39 */
+#else
+	_PIN_PE(0), /* 22 */
+	_PIN_PE(2), /* 23 */
+	_PIN_PE(4), /* 24 */
+	_PIN_PE(6), /* 25 */
+	_PIN_PE(5), /* 26 */
+	_PIN_PC(6), /* 27 */
+#endif
+#endif
+};
+#endif
+
 #ifdef ARDUINO_MAIN
 
 // On the Arduino board, digital pins are also used